@@ -17,7 +17,8 @@
 --      currently alive and either 2 or 3 neighbors are alive, then the cell remains alive. Otherwise, the alive cell dies
 --      due to overpopulation. 
 --
---      Note: in this version of the Game of Life, boundaries are closed and set to dead. 
+--      Note: by default, boundaries are closed and set to dead. If wrap = 1, the array is a torus instead: cells on an 
+--      edge take the cells on the opposite edge (and corners the opposite corner) as their neighbors. 
 --
 --		if Shift active then data is shifted into (from DataIn) the systolic array starting at the upper left corner and out 
 --      (to DataOut) from the bottom right corner. Aside from these two corner cases, data shifts to the cell to immediate 
@@ -41,7 +42,8 @@ use ieee.numeric_std.all;
 entity GOL is 
 	generic (
 		rows  :  integer := 10;    -- default # of rows is 10 
-		columns : integer := 10    -- default # of columns is 10 
+		columns : integer := 10;   -- default # of columns is 10 
+		wrap : integer := 0        -- 1: opposite edges are neighbors (torus), 0: boundaries are dead 
 	);
 
 	port (
@@ -78,196 +80,69 @@ architecture Behavioral of GOL is
 	-- There is one top level status signal that is used for propogating shifted data through the systolic array
 	signal status : std_logic_vector(rows*columns-1 downto 0);
 
+	-- Shift source of each cell, and the array framed by its boundary cells (see HaloRows below)
+	signal shift_in : std_logic_vector(rows*columns-1 downto 0);
+	signal halo : std_logic_vector((rows+2)*(columns+2)-1 downto 0);
+
 begin
 
 --------------------------------------------------------------------------------------------------------------------
--- Now, generate the m x n array. 
+-- Each cell shifts in the cell before it in the chain, the upper left corner shifts in DataIn. 
+shift_in(0) <= DataIn;
+ShiftChain:
+	if rows*columns > 1 generate
+		shift_in(rows*columns-1 downto 1) <= status(rows*columns-2 downto 0);
+	end generate ShiftChain;
+
+--------------------------------------------------------------------------------------------------------------------
+-- Frame the array with a ring of boundary cells so that every cell takes its neighbors from the same 3x3 window of 
+-- halo. The ring is dead (closed boundary), or if wrap = 1 a copy of the opposite edge of the array (a torus). Halo 
+-- cell (hi, hj) is array cell ((hi-1) mod rows, (hj-1) mod columns). 
+HaloRows:
+   for hi in 0 to rows+1 generate
+	begin
+	HaloColumns:
+		for hj in 0 to columns+1 generate
+			constant si : integer := (hi + rows - 1) mod rows;
+			constant sj : integer := (hj + columns - 1) mod columns;
+			constant inside : boolean := hi > 0 and hi <= rows and hj > 0 and hj <= columns;
+		begin
+		HaloCell:
+			if wrap /= 0 or inside generate
+				halo((columns+2)*hi+hj) <= status(columns*si+sj);
+			end generate HaloCell;
+		HaloDead:
+			if wrap = 0 and not inside generate
+				halo((columns+2)*hi+hj) <= '0';
+			end generate HaloDead;
+		end generate HaloColumns;
+	end generate HaloRows;
+
+--------------------------------------------------------------------------------------------------------------------
+-- Now, generate the m x n array. Cell (i, j) is halo cell (i+1, j+1). 
 ArrayRows:
    for i in 0 to rows-1 generate
 	begin
 	ArrayColumns: 
 		for j in 0 to columns-1 generate
 		begin
-		ArrayLeftEdge:
-			if j = 0 and i < rows-1 and i > 0 generate          				  -- left edge no corner
-				LeftEdgeCell : GOLCell 
-					port map (
-						status => status(columns*i+j),
-						Shift => Shift,
-						NextTimeTick => NextTimeTick,
-						clock => clock,
-						DataIn => status(columns*i+j-1), 
-
-						top_left => '0',
-						top_right => status(columns*i+j-columns+1),
-						bot_left => '0',
-						bot_right => status(columns*i+j+columns+1),
-						mid_left => '0',
-						mid_right => status(columns*i+j+1),
-						mid_top => status(columns*i+j-columns),
-						mid_bot => status(columns*i+j+columns)
-					);
-			end generate ArrayLeftEdge;
-		ArrayTopLeft:
-			if j = 0 and i = 0 generate                      					 -- top left corner
-				TopLeftCell : GOLCell 
-					port map (
-						status => status(columns*i+j),
-						Shift => Shift,
-						NextTimeTick => NextTimeTick,
-						clock => clock,
-						DataIn => DataIn, 										 -- shift DataIn into top left
-
-						top_left => '0',
-						top_right => '0',
-						bot_left => '0',
-						bot_right => status(columns*i+j+columns+1),
-						mid_left => '0',
-						mid_right => status(columns*i+j+1),
-						mid_top => '0',
-						mid_bot => status(columns*i+j+columns)
-					);
-			end generate ArrayTopLeft;
-		ArrayBotLeft:
-			if j = 0 and i = rows-1 generate                                     -- bottom left corner							
-				BotLeftCell : GOLCell 
-					port map (
-						status => status(columns*i+j),
-						Shift => Shift,
-						NextTimeTick => NextTimeTick,
-						clock => clock,
-						DataIn => status(columns*i+j-1), 
-
-						top_left => '0',
-						top_right => status(columns*i+j-columns+1),
-						bot_left => '0',
-						bot_right => '0', 
-						mid_left => '0',
-						mid_right => status(columns*i+j+1),
-						mid_top => status(columns*i+j-columns),
-						mid_bot => '0'
-					);
-			end generate ArrayBotLeft;
-		ArrayRightEdge:
-			if j = columns-1 and i < rows-1 and i > 0 generate                  -- right edge no corner
-				RightEdgeCell : GOLCell 
-					port map (
-						status => status(columns*i+j),
-						Shift => Shift,
-						NextTimeTick => NextTimeTick,
-						clock => clock,
-						DataIn => status(columns*i+j-1), 
-
-						top_left => status(columns*i+j-columns-1),
-						top_right => '0',
-						bot_left => status(columns*i+j+columns-1),
-						bot_right => '0',
-						mid_left => status(columns*i+j-1),
-						mid_right => '0',
-						mid_top => status(columns*i+j-columns),
-						mid_bot => status(columns*i+j+columns)
-					);
-			end generate ArrayRightEdge;
-		ArrayTopRight:
-			if j = columns-1 and i = 0 generate								    -- top right corner
-				TopRightCell : GOLCell 
-					port map (
-						status => status(columns*i+j),
-						Shift => Shift,
-						NextTimeTick => NextTimeTick,
-						clock => clock,
-						DataIn => status(columns*i+j-1), 
-
-						top_left => '0',
-						top_right => '0',
-						bot_left => status(columns*i+j+columns-1),
-						bot_right => '0',
-						mid_left => status(columns*i+j-1),
-						mid_right => '0',
-						mid_top => '0',
-						mid_bot => status(columns*i+j+columns)
-					);
-			end generate ArrayTopRight;
-		ArrayBotRight:
-			if j = columns-1 and i = rows-1 generate                             -- bottom right corner
-				BotRightCell : GOLCell 
-					port map (
-						status => status(columns*i+j),
-						Shift => Shift,
-						NextTimeTick => NextTimeTick,
-						clock => clock,
-						DataIn => status(columns*i+j-1), 
-
-						top_left => status(columns*i+j-columns-1),
-						top_right => '0',
-						bot_left => '0',
-						bot_right => '0',
-						mid_left => status(columns*i+j-1),
-						mid_right => '0',
-						mid_top => status(columns*i+j-columns),
-						mid_bot => '0'
-					);
-			end generate ArrayBotRight;
-		ArrayTopEdge:
-			if j < columns-1 and j > 0 and i = 0 generate                        -- top edge no corner
-				TopEdgeCell : GOLCell 
-					port map (
-						status => status(columns*i+j),
-						Shift => Shift,
-						NextTimeTick => NextTimeTick,
-						clock => clock,
-						DataIn => status(columns*i+j-1), 
-
-						top_left => '0',
-						top_right => '0',
-						bot_left => status(columns*i+j+columns-1),
-						bot_right => status(columns*i+j+columns+1), 
-						mid_left => status(columns*i+j-1),
-						mid_right => status(columns*i+j+1),
-						mid_top => '0',
-						mid_bot => status(columns*i+j+columns)
-					);
-			end generate ArrayTopEdge;
-		ArrayBotEdge:
-			if j < columns-1 and j > 0 and i = rows-1 generate                   -- bottom edge no corner
-				BotEdgeCell : GOLCell 
-					port map (
-						status => status(columns*i+j),
-						Shift => Shift,
-						NextTimeTick => NextTimeTick,
-						clock => clock,
-						DataIn => status(columns*i+j-1), 
-
-						top_left => status(columns*i+j-columns-1),
-						top_right => status(columns*i+j-columns+1),
-						bot_left => '0',
-						bot_right => '0',
-						mid_left => status(columns*i+j-1),
-						mid_right => status(columns*i+j+1),
-						mid_top => status(columns*i+j-columns),
-						mid_bot => '0'
-					);
-			end generate ArrayBotEdge;
-		ArrayInt:
-			if j < columns-1 and j > 0 and i < rows-1 and i > 0 generate         -- interior cell
-				IntCell : GOLCell 
-					port map (
-						status => status(columns*i+j),
-						Shift => Shift,
-						NextTimeTick => NextTimeTick,
-						clock => clock,
-						DataIn => status(columns*i+j-1), 
-
-						top_left => status(columns*i+j-columns-1),
-						top_right => status(columns*i+j-columns+1),
-						bot_left => status(columns*i+j+columns-1),
-						bot_right => status(columns*i+j+columns+1), 
-						mid_left => status(columns*i+j-1),
-						mid_right => status(columns*i+j+1),
-						mid_top => status(columns*i+j-columns),
-						mid_bot => status(columns*i+j+columns)
-					);
-			end generate ArrayInt;
+			Cell : GOLCell 
+				port map (
+					status => status(columns*i+j),
+					Shift => Shift,
+					NextTimeTick => NextTimeTick,
+					clock => clock,
+					DataIn => shift_in(columns*i+j), 
+
+					top_left => halo((columns+2)*i+j),
+					top_right => halo((columns+2)*i+j+2),
+					bot_left => halo((columns+2)*(i+2)+j),
+					bot_right => halo((columns+2)*(i+2)+j+2),
+					mid_left => halo((columns+2)*(i+1)+j),
+					mid_right => halo((columns+2)*(i+1)+j+2),
+					mid_top => halo((columns+2)*i+j+1),
+					mid_bot => halo((columns+2)*(i+2)+j+1)
+				);
 		end generate ArrayColumns;
 	end generate ArrayRows;
 
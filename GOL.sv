@@ -3,10 +3,11 @@
 //  Conway's Game of Life
 //
 //  This file contains the top-level implementation of Conway's Game of Life using a parametrized m x n systolic array. 
-//  The top-level entity connects a total of m x n Game of Life cells in an m x n array. The top level contains 4 inputs 
-//  and 2 outputs. The clock input is the system clock. The NextTimeTick and Shift inputs are mode selection signals which 
-//  determine how the cells update on the rising edge of the clock (internal to each cell). The DataIn input is used to shift
-//  data into the systolic array. The DataOut output is the shifted out data when shifting data into the systolic array. 
+//  The top-level entity connects a total of m x n Game of Life cells in an m x n array. The top level contains 6 inputs 
+//  and 2 outputs. The clock input is the system clock. The NextTimeTick, Shift and ShiftPar inputs are mode selection 
+//  signals which determine how the cells update on the rising edge of the clock (internal to each cell). The DataIn input 
+//  is used to shift data into the systolic array. The DataOut output is the shifted out data when shifting data into the 
+//  systolic array. DataInPar and DataOutPar (port_width bits each) are the same for the parallel shift (see below). 
 //  The systolic array is set up so that data is shifted into (from DataIn) the upper left corner of the m x n array and 
 //  out (into DataOut) from the bottom right corner of the m x n array. 
 //
@@ -15,8 +16,11 @@
 //     - If the cell is currently dead and exactly 3 neighbors are alive, the cell is resurrected and becomes alive.
 //     - If the cell is currently alive and either 2 or 3 neighbors are alive, the cell remains alive.
 //     - In all other cases, the cell dies due to overpopulation or underpopulation.
+//  Other life-like rules are selected with the birth and survive masks (B/S notation, see GOLRule), e.g. HighLife 
+//  B36/S23 with birth = 9'h048. 
 //  
-//  Note: In this version of the Game of Life, boundaries are closed and set to dead. 
+//  Note: By default, boundaries are closed and set to dead. With wrap set, the array is a torus instead: cells on an 
+//  edge take the cells on the opposite edge (and corners the opposite corner) as their neighbors. 
 //
 //  If Shift is active, data is shifted into (from DataIn) the systolic array starting at the upper left corner and out 
 //  (to DataOut) from the bottom right corner. Aside from these two corner cases, data shifts to the immediate right of 
@@ -24,6 +28,18 @@
 //  row below. This shift mode is used for loading in initial states into the game as well as for checking the status of 
 //  the game after each iteration. 
 //
+//  If ShiftPar is active, the same chain is shifted port_width cells per clock instead of one. The first port_width 
+//  cells (upper left) load DataInPar, every other cell takes the cell port_width positions before it in the chain, and 
+//  DataOutPar presents the last port_width cells (DataOutPar[k] = cell rows*columns-port_width+k). port_width must 
+//  divide columns, so port_width = columns gives a full-row parallel load/readback and loading or checking the array 
+//  takes rows*columns/port_width clocks instead of rows*columns. 
+//
+//  With gens_per_tick = G > 1, each NextTimeTick advances the game by G generations in a single clock. The rule is 
+//  unrolled G times: generation g+1 of every cell is computed combinationally (GOLRule) from generation g of its 3x3 
+//  window, each generation framed by its own halo ring, so a cell's result depends on the (2G+1)x(2G+1) window around 
+//  it. The array registers then hold every G-th generation. The combinational path grows with G, trading clock rate 
+//  for generations per clock. With G = 1 the array is the plain GOLCell array. 
+//
 //  Revision History:
 //     05 Mar 23  Hector Wilson       Initial revision.
 //     06 Mar 23  Hector Wilson       Completed assignment. Updated calculation of neighbors. 
@@ -33,193 +49,137 @@
 
 module GOL #(
     parameter integer rows = 10,     // Default number of rows
-    parameter integer columns = 10   // Default number of columns
+    parameter integer columns = 10,  // Default number of columns
+    parameter integer port_width = 1, // Cells moved per clock by the parallel port (must divide columns)
+    parameter integer wrap = 0,      // 1: opposite edges are neighbors (torus), 0: cells outside the array are dead
+    parameter integer cell_counter = 0, // GOLCell neighbor counter: 0 = adder, 1 = compressor tree (see GOLRule)
+    parameter integer gens_per_tick = 1, // Generations computed per NextTimeTick (unrolled, see above)
+    parameter [8:0] birth = 9'h008,         // Rule: neighbor counts that bring a dead cell to life (default B3)
+    parameter [8:0] survive = 9'h00C        // Rule: neighbor counts that keep an alive cell alive (default S23)
 )(
     input logic clock,               // System clock
     input logic NextTimeTick,        // Game play signal
     input logic Shift,               // Data shift signal
     input logic DataIn,              // Input data to shift in
-    output logic DataOut             // Output data shifted out
+    output logic DataOut,            // Output data shifted out
+
+    input logic ShiftPar,                       // Parallel data shift signal
+    input logic [port_width-1:0] DataInPar,     // Input data to shift in, port_width cells per clock
+    output logic [port_width-1:0] DataOutPar    // Output data shifted out, port_width cells per clock
 );
 
-    // Declare the array of Game of Life cells
-    logic [rows*columns-1:0] status; 
+    // Declare the array of Game of Life cells (public so the testbench can read the whole array without shifting)
+    logic [rows*columns-1:0] status /*verilator public_flat_rd*/; 
 
-    // Instantiate each Game of Life cell in the systolic array
-    genvar i, j;
+    // Shift source of each cell and shift enable for either shift mode
+    logic [rows*columns-1:0] shift_in;
+    logic shift_en;
+
+    assign shift_en = Shift | ShiftPar;
+
+    // Serial shift takes the previous cell in the chain, parallel shift takes the cell port_width positions back.
+    // The first cell takes DataIn and the first port_width cells take DataInPar.
+    genvar k;
     generate
-        for (i = 0; i < rows; i = i + 1) begin : ArrayRows
-            for (j = 0; j < columns; j = j + 1) begin : ArrayColumns
-                // Left edge cell (non-corner)
-                if (j == 0 && i > 0 && i < rows-1) begin : ArrayLeftEdge
-                    GOLCell LeftEdgeCell (
-                        .status(status[columns*i+j]),
-                        .Shift(Shift),
-                        .NextTimeTick(NextTimeTick),
-                        .clock(clock),
-                        .DataIn(status[columns*i+j-1]),
-
-                        .top_left(0),
-                        .top_right(status[columns*(i-1)+j+1]),
-                        .bot_left(0),
-                        .bot_right(status[columns*(i+1)+j+1]),
-                        .mid_left(0),
-                        .mid_right(status[columns*i+j+1]),
-                        .mid_top(status[columns*(i-1)+j]),
-                        .mid_bot(status[columns*(i+1)+j])
-                    );
-                end
-                // Top-left corner cell
-                else if (i == 0 && j == 0) begin : ArrayTopLeft
-                    GOLCell TopLeftCell (
-                        .status(status[columns*i+j]),
-                        .Shift(Shift),
-                        .NextTimeTick(NextTimeTick),
-                        .clock(clock),
-                        .DataIn(DataIn),  // Shift in data into the top-left corner
-
-                        .top_left(0),
-                        .top_right(0),
-                        .bot_left(0),
-                        .bot_right(status[columns*i+j+columns+1]),
-                        .mid_left(0),
-                        .mid_right(status[columns*i+j+1]),
-                        .mid_top(0),
-                        .mid_bot(status[columns*i+j+columns])
-                    );
-                end
-                // Bottom-left corner cell
-                else if (i == rows-1 && j == 0) begin : ArrayBotLeft
-                    GOLCell BotLeftCell (
-                        .status(status[columns*i+j]),
-                        .Shift(Shift),
-                        .NextTimeTick(NextTimeTick),
-                        .clock(clock),
-                        .DataIn(status[columns*i+j-1]),
-
-                        .top_left(0),
-                        .top_right(status[columns*(i-1)+j+1]),
-                        .bot_left(0),
-                        .bot_right(0),
-                        .mid_left(0),
-                        .mid_right(status[columns*i+j+1]),
-                        .mid_top(status[columns*(i-1)+j]),
-                        .mid_bot(0)
-                    );
-                end
-                // Right edge cell (non-corner)
-                else if (j == columns-1 && i > 0 && i < rows-1) begin : ArrayRightEdge
-                    GOLCell RightEdgeCell (
-                        .status(status[columns*i+j]),
-                        .Shift(Shift),
-                        .NextTimeTick(NextTimeTick),
-                        .clock(clock),
-                        .DataIn(status[columns*i+j-1]),
-
-                        .top_left(status[columns*(i-1)+j-1]),
-                        .top_right(0),
-                        .bot_left(status[columns*(i+1)+j-1]),
-                        .bot_right(0),
-                        .mid_left(status[columns*i+j-1]),
-                        .mid_right(0),
-                        .mid_top(status[columns*(i-1)+j]),
-                        .mid_bot(status[columns*(i+1)+j])
-                    );
-                end
-                // Top-right corner cell
-                else if (i == 0 && j == columns-1) begin : ArrayTopRight
-                    GOLCell TopRightCell (
-                        .status(status[columns*i+j]),
-                        .Shift(Shift),
-                        .NextTimeTick(NextTimeTick),
-                        .clock(clock),
-                        .DataIn(status[columns*i+j-1]),
-
-                        .top_left(0),
-                        .top_right(0),
-                        .bot_left(status[columns*(i+1)+j-1]),
-                        .bot_right(0),
-                        .mid_left(status[columns*i+j-1]),
-                        .mid_right(0),
-                        .mid_top(0),
-                        .mid_bot(status[columns*(i+1)+j])
-                    );
+        for (k = 0; k < rows*columns; k = k + 1) begin : ShiftChain
+            if (k == 0) begin : ShiftFirst
+                assign shift_in[k] = ShiftPar ? DataInPar[k] : DataIn;
+            end
+            else if (k < port_width) begin : ShiftPort
+                assign shift_in[k] = ShiftPar ? DataInPar[k] : status[k-1];
+            end
+            else begin : ShiftInt
+                assign shift_in[k] = ShiftPar ? status[k-port_width] : status[k-1];
+            end
+        end
+    endgenerate
+
+    // Generation g of the array after the registers (stage[0] = status, stage[gens_per_tick] is what NextTimeTick 
+    // loads). Only gens_per_tick > 1 computes the stages past 0, GOLCell computes the single step itself, so then 
+    // stage[0] is the only stage there is (the halo still reads it). 
+    localparam integer stages = gens_per_tick > 1 ? gens_per_tick + 1 : 1;
+    logic [rows*columns-1:0] stage [stages];
+
+    assign stage[0] = status;
+
+    // Each generation framed by a ring of boundary cells, so every cell takes its eight neighbors from the same 3x3 
+    // window of halo. The ring is dead (closed boundary), or with wrap a copy of the opposite edge of the array (a 
+    // torus): halo cell (hi, hj) is array cell ((hi-1) mod rows, (hj-1) mod columns).
+    localparam integer halo_columns = columns + 2;
+    logic [(rows+2)*halo_columns-1:0] halo [gens_per_tick];
+
+    genvar g, hi, hj;
+    generate
+        for (g = 0; g < gens_per_tick; g = g + 1) begin : HaloGens
+            for (hi = 0; hi < rows+2; hi = hi + 1) begin : HaloRows
+                for (hj = 0; hj < halo_columns; hj = hj + 1) begin : HaloColumns
+                    localparam integer si = (hi + rows - 1) % rows;
+                    localparam integer sj = (hj + columns - 1) % columns;
+                    if (wrap != 0 || (hi > 0 && hi <= rows && hj > 0 && hj <= columns)) begin : HaloCell
+                        assign halo[g][halo_columns*hi+hj] = stage[g][columns*si+sj];
+                    end
+                    else begin : HaloDead
+                        assign halo[g][halo_columns*hi+hj] = 1'b0;
+                    end
                 end
-                // Bottom-right corner cell
-                else if (i == rows-1 && j == columns-1) begin : ArrayBotRight
-                    GOLCell BotRightCell (
+            end
+        end
+    endgenerate
+
+    // Instantiate each Game of Life cell in the systolic array. Cell (i, j) is halo cell (i+1, j+1).
+    genvar i, j;
+    generate
+        if (gens_per_tick == 1) begin : SingleGen
+            for (i = 0; i < rows; i = i + 1) begin : ArrayRows
+                for (j = 0; j < columns; j = j + 1) begin : ArrayColumns
+                    GOLCell #(.counter(cell_counter), .birth(birth), .survive(survive)) Cell (
                         .status(status[columns*i+j]),
-                        .Shift(Shift),
+                        .Shift(shift_en),
                         .NextTimeTick(NextTimeTick),
                         .clock(clock),
-                        .DataIn(status[columns*i+j-1]),
-
-                        .top_left(status[columns*(i-1)+j-1]),
-                        .top_right(0),
-                        .bot_left(0),
-                        .bot_right(0),
-                        .mid_left(status[columns*i+j-1]),
-                        .mid_right(0),
-                        .mid_top(status[columns*(i-1)+j]),
-                        .mid_bot(0)
+                        .DataIn(shift_in[columns*i+j]),
+
+                        .top_left(halo[0][halo_columns*i+j]),
+                        .top_right(halo[0][halo_columns*i+j+2]),
+                        .bot_left(halo[0][halo_columns*(i+2)+j]),
+                        .bot_right(halo[0][halo_columns*(i+2)+j+2]),
+                        .mid_left(halo[0][halo_columns*(i+1)+j]),
+                        .mid_right(halo[0][halo_columns*(i+1)+j+2]),
+                        .mid_top(halo[0][halo_columns*i+j+1]),
+                        .mid_bot(halo[0][halo_columns*(i+2)+j+1])
                     );
                 end
-                // Top edge cell (non-corner)
-                else if (i == 0 && j > 0 && j < columns-1) begin : ArrayTopEdge
-                    GOLCell TopEdgeCell (
-                        .status(status[columns*i+j]),
-                        .Shift(Shift),
-                        .NextTimeTick(NextTimeTick),
-                        .clock(clock),
-                        .DataIn(status[columns*i+j-1]),
-
-                        .top_left(0),
-                        .top_right(0),
-                        .bot_left(status[columns*(i+1)+j-1]),
-                        .bot_right(status[columns*(i+1)+j+1]),
-                        .mid_left(status[columns*i+j-1]),
-                        .mid_right(status[columns*i+j+1]),
-                        .mid_top(0),
-                        .mid_bot(status[columns*(i+1)+j])
-                    );
+            end
+        end
+        else begin : MultiGen
+            // Unrolled generations: stage g+1 is the rule applied to every cell of stage g
+            for (g = 0; g < gens_per_tick; g = g + 1) begin : Gens
+                for (i = 0; i < rows; i = i + 1) begin : ArrayRows
+                    for (j = 0; j < columns; j = j + 1) begin : ArrayColumns
+                        GOLRule #(.counter(cell_counter), .birth(birth), .survive(survive)) Rule (
+                            .status(stage[g][columns*i+j]),
+                            .top_left(halo[g][halo_columns*i+j]),
+                            .top_right(halo[g][halo_columns*i+j+2]),
+                            .bot_left(halo[g][halo_columns*(i+2)+j]),
+                            .bot_right(halo[g][halo_columns*(i+2)+j+2]),
+                            .mid_left(halo[g][halo_columns*(i+1)+j]),
+                            .mid_right(halo[g][halo_columns*(i+1)+j+2]),
+                            .mid_top(halo[g][halo_columns*i+j+1]),
+                            .mid_bot(halo[g][halo_columns*(i+2)+j+1]),
+                            .next(stage[g+1][columns*i+j])
+                        );
+                    end
                 end
-                // Bottom edge cell (non-corner)
-                else if (i == rows-1 && j > 0 && j < columns-1) begin : ArrayBotEdge
-                    GOLCell BotEdgeCell (
-                        .status(status[columns*i+j]),
-                        .Shift(Shift),
-                        .NextTimeTick(NextTimeTick),
-                        .clock(clock),
-                        .DataIn(status[columns*i+j-1]),
-
-                        .top_left(status[columns*(i-1)+j-1]),
-                        .top_right(status[columns*(i-1)+j+1]),
-                        .bot_left(0),
-                        .bot_right(0),
-                        .mid_left(status[columns*i+j-1]),
-                        .mid_right(status[columns*i+j+1]),
-                        .mid_top(status[columns*(i-1)+j]),
-                        .mid_bot(0)
-                    );
+            end
+
+            // The array registers, same as in GOLCell: NextTimeTick loads the last generation, Shift has priority
+            always_ff @(posedge clock) begin
+                if (NextTimeTick) begin
+                    status <= stage[gens_per_tick];
                 end
-                // Interior cell
-                else if (i > 0 && i < rows-1 && j > 0 && j < columns-1) begin : ArrayInt
-                    GOLCell IntCell (
-                        .status(status[columns*i+j]),
-                        .Shift(Shift),
-                        .NextTimeTick(NextTimeTick),
-                        .clock(clock),
-                        .DataIn(status[columns*i+j-1]),
-
-                        .top_left(status[columns*(i-1)+j-1]),
-                        .top_right(status[columns*(i-1)+j+1]),
-                        .bot_left(status[columns*(i+1)+j-1]),
-                        .bot_right(status[columns*(i+1)+j+1]),
-                        .mid_left(status[columns*i+j-1]),
-                        .mid_right(status[columns*i+j+1]),
-                        .mid_top(status[columns*(i-1)+j]),
-                        .mid_bot(status[columns*(i+1)+j])
-                    );
+
+                if (shift_en) begin
+                    status <= shift_in;
                 end
             end
         end
@@ -228,5 +188,8 @@ module GOL #(
     // DataOut is the last cell in the systolic array (bottom-right corner)
     assign DataOut = status[columns*rows-1];
 
+    // DataOutPar is the last port_width cells in the systolic array
+    assign DataOutPar = status[columns*rows-1 -: port_width];
+
 endmodule
 
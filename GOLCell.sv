@@ -12,9 +12,13 @@
 //     - If the cell is dead and exactly 3 neighbors are alive, the cell becomes alive.
 //     - If the cell is alive and has 2 or 3 neighbors alive, the cell remains alive.
 //     - In all other cases, the cell dies (either due to overpopulation or underpopulation).
+//     Other life-like rules are selected with the birth and survive masks (B/S notation). 
 //   - If Shift is active, the cell shifts the DataIn input into its current status. This is used to shift in the initial 
 //     states of the game or to check results after each iteration. 
 //
+//  The rules are evaluated by GOLRule, whose counter parameter selects the neighbor counter and whose birth and survive 
+//  masks select the rule (see GOLRule.sv).
+//
 //  Revision History:
 //     05 Mar 23  Hector Wilson       Initial revision.
 //     06 Mar 23  Hector Wilson       Completed assignment. Updated calculation of neighbors. 
@@ -22,7 +26,11 @@
 //
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-module GOLCell (
+module GOLCell #(
+    parameter integer counter = 0,          // Neighbor counter: 0 = adder, 1 = compressor tree
+    parameter [8:0] birth = 9'h008,         // Neighbor counts that bring a dead cell to life (default B3)
+    parameter [8:0] survive = 9'h00C        // Neighbor counts that keep an alive cell alive (default S23)
+)(
     input logic clock,              // Global clock
     input logic NextTimeTick,       // Game tick signal
     input logic Shift,              // Shift data signal
@@ -44,33 +52,26 @@ module GOLCell (
     // Internal register to store the current status
     logic status0;
 
-    // Define neighbors as a 3-bit wide signal to store the sum of up to 8 neighbors.
-    logic [2:0] neighbors;
+    // Next status under the game rules, from the cell's own status and its neighbors
+    logic next;
 
-    // Calculate the number of alive neighbors (explicitly widen the inputs to 3 bits).
-    always_comb begin
-        neighbors = ({2'b0, top_left} + {2'b0, top_right} + 
-                     {2'b0, bot_left} + {2'b0, bot_right} + 
-                     {2'b0, mid_left} + {2'b0, mid_right} + 
-                     {2'b0, mid_top} + {2'b0, mid_bot});
-    end
+    GOLRule #(.counter(counter), .birth(birth), .survive(survive)) Rule (
+        .status(status0),
+        .top_left(top_left),
+        .top_right(top_right),
+        .bot_left(bot_left),
+        .bot_right(bot_right),
+        .mid_left(mid_left),
+        .mid_right(mid_right),
+        .mid_top(mid_top),
+        .mid_bot(mid_bot),
+        .next(next)
+    );
 
     // Update the status based on the game rules
     always_ff @(posedge clock) begin
         if (NextTimeTick) begin
-            if (status0 == 0) begin
-                // Cell is dead, check if exactly 3 neighbors are alive
-                if (neighbors == 3) 
-                    status0 <= 1;  // Cell becomes alive
-                else 
-                    status0 <= 0;  // Cell remains dead
-            end else begin
-                // Cell is alive, check if 2 or 3 neighbors are alive
-                if (neighbors == 2 || neighbors == 3)
-                    status0 <= 1;  // Cell remains alive
-                else 
-                    status0 <= 0;  // Cell dies
-            end
+            status0 <= next;
         end
 
         // If Shift is active, the cell takes the value of DataIn as its new status
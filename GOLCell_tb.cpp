@@ -0,0 +1,82 @@
+#include "VGOLCell.h"
+#include <verilated.h>
+#include <stdlib.h>
+#include <iostream>
+
+using namespace std;
+
+// Neighbor counter and rule masks the cell was built with (-Gcounter, -Gbirth, -Gsurvive, see the cell-test target
+// in the Makefile)
+#ifndef GOL_CELL_COUNTER
+#define GOL_CELL_COUNTER 0
+#endif
+#ifndef GOL_BIRTH
+#define GOL_BIRTH 0x008
+#endif
+#ifndef GOL_SURVIVE
+#define GOL_SURVIVE 0x00C
+#endif
+
+// Function to apply one rising clock edge
+static void clock_edge(VGOLCell& cell) {
+    cell.clock = 0;
+    cell.eval();
+    cell.clock = 1;
+    cell.eval();
+}
+
+// Function to shift a status into the cell through DataIn
+static void load_status(VGOLCell& cell, bool alive) {
+    cell.NextTimeTick = 0;
+    cell.Shift = 1;
+    cell.DataIn = alive;
+    clock_edge(cell);
+    cell.Shift = 0;
+}
+
+// Exhaustive GOLCell bench: every combination of the 8 neighbor inputs with the cell dead and alive (512 cases). Each
+// case shifts in the current status, checks that the cell holds it while NextTimeTick is low, then applies one game
+// tick and compares the new status with the rules.
+int main(int argc, char** argv) {
+    VerilatedContext context;
+    context.commandArgs(argc, argv);
+    VGOLCell cell(&context);
+
+    int failed = 0;
+    for (int c = 0; c < 512; ++c) {
+        int neighbors = c & 0xff;
+        bool alive = c >> 8;
+        load_status(cell, alive);
+
+        cell.top_left = neighbors >> 0 & 1;
+        cell.top_right = neighbors >> 1 & 1;
+        cell.bot_left = neighbors >> 2 & 1;
+        cell.bot_right = neighbors >> 3 & 1;
+        cell.mid_left = neighbors >> 4 & 1;
+        cell.mid_right = neighbors >> 5 & 1;
+        cell.mid_top = neighbors >> 6 & 1;
+        cell.mid_bot = neighbors >> 7 & 1;
+        clock_edge(cell);
+        bool held = cell.status;
+
+        cell.NextTimeTick = 1;
+        clock_edge(cell);
+        cell.NextTimeTick = 0;
+
+        int count = __builtin_popcount(neighbors);
+        bool expected = ((alive ? GOL_SURVIVE : GOL_BIRTH) >> count) & 1;
+        if (held != alive || bool(cell.status) != expected) {
+            if (failed < 10) {
+                cout << "FAILED " << (alive ? "alive" : "dead") << " cell, neighbors 0x" << hex << neighbors << dec
+                     << " (" << count << " alive): held " << held << ", next " << int(cell.status)
+                     << ", expected " << expected << endl;
+            }
+            failed++;
+        }
+    }
+    cell.final();
+
+    cout << "GOLCell counter=" << GOL_CELL_COUNTER << " birth=0x" << hex << GOL_BIRTH << " survive=0x" << GOL_SURVIVE
+         << dec << ": " << 512 - failed << "/512 cases passed" << endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  
+//  Conway's Game of Life
+//
+//  This file contains the combinational rule of a Game of Life cell: given the current status of a cell and its 8 
+//  neighbors, next is the status of the cell one generation later. Any life-like rule can be used, given in B/S 
+//  notation as two 9-bit masks indexed by the number of alive neighbors (0 to 8):
+//     - If the cell is dead and birth[n] is set for its n alive neighbors, the cell becomes alive.
+//     - If the cell is alive and survive[n] is set, the cell remains alive.
+//     - In all other cases, the cell dies.
+//  The defaults are Conway's rule B3/S23 (birth = 3, survive = 2 or 3), e.g. HighLife B36/S23 is birth = 9'h048, 
+//  survive = 9'h00C and Day & Night B3678/S34678 is birth = 9'h1C8, survive = 9'h1D8.
+//
+//  GOLCell registers it once per NextTimeTick. GOL with gens_per_tick > 1 chains it over several generations within 
+//  one clock, and GOLStream evaluates one row of it per streamed row. 
+//
+//  The neighbor count comes from one of two counters, selected by the counter parameter:
+//   - counter = 0: an adder summing the 8 inputs into a 4-bit count, compared against 2 and 3.
+//   - counter = 1: a carry-save compressor tree (full and half adders) that never forms the full count. It reduces the 
+//     8 inputs to a ones bit and four weight-2 carries; the count is 2 or 3 exactly when one carry is set, and the 
+//     ones bit then tells 3 from 2. This is shallower than the adder, which is the critical path of a cell. For a rule 
+//     other than B3/S23 the carries are summed into the upper bits of the count instead and the count indexes the 
+//     masks, like the adder. 
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+module GOLRule #(
+    parameter integer counter = 0,          // Neighbor counter: 0 = adder, 1 = compressor tree
+    parameter [8:0] birth = 9'h008,         // Neighbor counts that bring a dead cell to life (default B3)
+    parameter [8:0] survive = 9'h00C        // Neighbor counts that keep an alive cell alive (default S23)
+)(
+    input logic status,             // Current cell status (0 = dead, 1 = alive)
+
+    input logic top_left,           // Top-left neighbor
+    input logic top_right,          // Top-right neighbor
+    input logic bot_left,           // Bottom-left neighbor
+    input logic bot_right,          // Bottom-right neighbor
+    input logic mid_left,           // Middle-left neighbor
+    input logic mid_right,          // Middle-right neighbor
+    input logic mid_top,            // Middle-top neighbor
+    input logic mid_bot,            // Middle-bottom neighbor
+
+    output logic next               // Cell status in the next generation
+);
+
+    // Conway's rule only needs to know whether exactly 2 or exactly 3 neighbors are alive
+    localparam conway = (birth == 9'h008) && (survive == 9'h00C);
+    logic two, three;
+
+    // Number of alive neighbors (the compressor only forms it for rules other than B3/S23)
+    logic [3:0] neighbors;
+
+    generate
+        if (counter == 0) begin : AdderCount
+            // Calculate the number of alive neighbors (explicitly widen the inputs to 4 bits).
+            always_comb begin
+                neighbors = ({3'b0, top_left} + {3'b0, top_right} + 
+                             {3'b0, bot_left} + {3'b0, bot_right} + 
+                             {3'b0, mid_left} + {3'b0, mid_right} + 
+                             {3'b0, mid_top} + {3'b0, mid_bot});
+            end
+
+            assign two = (neighbors == 2);
+            assign three = (neighbors == 3);
+        end
+        else begin : CompressorCount
+            // First layer: two full adders and a half adder turn the 8 inputs into 3 sums (weight 1) and 3 carries
+            // (weight 2)
+            logic s0, c0, s1, c1, s2, c2;
+            assign s0 = top_left ^ top_right ^ bot_left;
+            assign c0 = (top_left & top_right) | (bot_left & (top_left ^ top_right));
+            assign s1 = bot_right ^ mid_left ^ mid_right;
+            assign c1 = (bot_right & mid_left) | (mid_right & (bot_right ^ mid_left));
+            assign s2 = mid_top ^ mid_bot;
+            assign c2 = mid_top & mid_bot;
+
+            // Second layer: a full adder on the sums gives the ones bit of the count and a fourth carry
+            logic ones, c3;
+            assign ones = s0 ^ s1 ^ s2;
+            assign c3 = (s0 & s1) | (s2 & (s0 ^ s1));
+
+            // count = ones + 2 * (carries set), so it is 2 or 3 when exactly one carry is set
+            logic one_carry;
+            assign one_carry = (c0 ^ c1 ^ c2 ^ c3) & ~((c0 & c1) | (c2 & c3));
+
+            assign two = one_carry & ~ones;
+            assign three = one_carry & ones;
+
+            // count = ones + 2 * (c0 + c1 + c2 + c3), only built when the rule needs the full count
+            assign neighbors = {{2'b0, c0} + {2'b0, c1} + {2'b0, c2} + {2'b0, c3}, ones};
+        end
+
+        if (conway) begin : ConwayRule
+            // A dead cell needs exactly 3 alive neighbors to become alive, an alive cell stays alive with 2 or 3
+            assign next = three | (status & two);
+        end
+        else begin : LifeLikeRule
+            // The neighbor count selects a bit of the mask for the cell's current status
+            assign next = status ? survive[neighbors] : birth[neighbors];
+        end
+    endgenerate
+
+endmodule
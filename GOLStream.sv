@@ -0,0 +1,105 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  
+//  Conway's Game of Life
+//
+//  This file contains a line-buffer streaming engine for Conway's Game of Life, an alternative top module to the 
+//  systolic array in GOL.sv for grids too large to hold one cell per grid cell. The grid lives off-chip and is 
+//  streamed through the engine one row per clock, in order from the top row down; each pass produces the next 
+//  generation of every row, one row behind the input. The number of rows is unlimited, only the row width (columns) 
+//  is fixed. 
+//
+//  The engine keeps a window of the last three rows it was given in three row buffers (top_row, mid_row, bot_row) and 
+//  one row of compute cells (GOLRule) that evaluates the middle row against its neighbors above and below: 
+//   - Start clears the window to dead rows to begin a pass, so the first row sees a dead row above it.
+//   - On each clock with RowValid, RowIn enters as the bottom row and the window moves down one row. 
+//   - One clock later RowOutValid is set and RowOut holds the next generation of the (new) middle row, i.e. of the 
+//     row given one RowValid earlier. The first RowValid after Start only fills the window and has no output. 
+//   - After the last row, one more (dead) row has to be given to flush out the next generation of the last row. 
+//
+//  Note: Left and right boundaries are dead by default. With wrap set they are neighbors instead (a horizontal 
+//  torus). The vertical boundary is up to the streaming side: for a full torus, stream the last row first, then every 
+//  row, then the first row again instead of a dead row, and drop the first RowOutValid output. 
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+module GOLStream #(
+    parameter integer columns = 64,     // Cells per row
+    parameter integer wrap = 0,         // 1: the left and right edges are neighbors, 0: cells past them are dead
+    parameter integer cell_counter = 0, // GOLRule neighbor counter: 0 = adder, 1 = compressor tree (see GOLRule)
+    parameter [8:0] birth = 9'h008,         // Rule: neighbor counts that bring a dead cell to life (default B3)
+    parameter [8:0] survive = 9'h00C        // Rule: neighbor counts that keep an alive cell alive (default S23)
+)(
+    input logic clock,                  // System clock
+    input logic Start,                  // Begin a pass (clears the window)
+    input logic RowValid,               // RowIn holds the next row of the grid
+    input logic [columns-1:0] RowIn,    // Row streamed in
+    output logic RowOutValid,           // RowOut holds the next generation of a row
+    output logic [columns-1:0] RowOut   // Next generation of the middle row of the window
+);
+
+    // Row buffers holding the window of three consecutive rows
+    logic [columns-1:0] top_row, mid_row, bot_row;
+
+    // Rows given since Start (saturates at 2: from then on mid_row holds a row of the grid)
+    logic [1:0] filled;
+
+    always_ff @(posedge clock) begin
+        RowOutValid <= 0;
+
+        if (RowValid) begin
+            // Move the window down one row
+            top_row <= mid_row;
+            mid_row <= bot_row;
+            bot_row <= RowIn;
+
+            RowOutValid <= (filled != 0);
+            if (filled != 2) filled <= filled + 1;
+        end
+
+        // Start has priority: the window is cleared to dead rows
+        if (Start) begin
+            top_row <= '0;
+            mid_row <= '0;
+            bot_row <= '0;
+            filled <= 0;
+            RowOutValid <= 0;
+        end
+    end
+
+    // Each window row framed by one boundary cell on either side (dead, or with wrap the opposite edge), so window 
+    // column j+1 is row column j
+    logic [columns+1:0] top_halo, mid_halo, bot_halo;
+
+    generate
+        if (wrap != 0) begin : HaloWrap
+            assign top_halo = {top_row[0], top_row, top_row[columns-1]};
+            assign mid_halo = {mid_row[0], mid_row, mid_row[columns-1]};
+            assign bot_halo = {bot_row[0], bot_row, bot_row[columns-1]};
+        end
+        else begin : HaloDead
+            assign top_halo = {1'b0, top_row, 1'b0};
+            assign mid_halo = {1'b0, mid_row, 1'b0};
+            assign bot_halo = {1'b0, bot_row, 1'b0};
+        end
+    endgenerate
+
+    // The row of compute cells: cell j is the next generation of mid_row[j]
+    genvar j;
+    generate
+        for (j = 0; j < columns; j = j + 1) begin : ComputeCells
+            GOLRule #(.counter(cell_counter), .birth(birth), .survive(survive)) Rule (
+                .status(mid_row[j]),
+                .top_left(top_halo[j]),
+                .top_right(top_halo[j+2]),
+                .bot_left(bot_halo[j]),
+                .bot_right(bot_halo[j+2]),
+                .mid_left(mid_halo[j]),
+                .mid_right(mid_halo[j+2]),
+                .mid_top(top_halo[j+1]),
+                .mid_bot(bot_halo[j+1]),
+                .next(RowOut[j])
+            );
+        end
+    endgenerate
+
+endmodule
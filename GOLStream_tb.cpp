@@ -0,0 +1,215 @@
+#include "VGOLStream.h"
+#include <verilated.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <string.h>
+#include "GOL_ref.h"
+#include "GOL_snapshot.h"
+#include "GOL_random.h"
+
+// Row width, horizontal boundary and rule the engine was built with (-Gcolumns, -Gwrap, -Gbirth, -Gsurvive, see the
+// stream targets in the Makefile)
+#ifndef GOL_STREAM_COLS
+#define GOL_STREAM_COLS 64
+#endif
+#ifndef GOL_WRAP
+#define GOL_WRAP 0
+#endif
+#ifndef GOL_BIRTH
+#define GOL_BIRTH 0x008
+#endif
+#ifndef GOL_SURVIVE
+#define GOL_SURVIVE 0x00C
+#endif
+
+using namespace std;
+
+// Streaming testbench options
+struct StreamOptions {
+    int rows = 1024;                     // --rows=N, rows of the random grid (any number, the engine doesn't care)
+    long generations = 16;               // --gens=N, passes through the engine
+    uint64_t seed = 1;                   // --seed=S
+    double density = 0.5;                // --density=P
+    const char* work_dir = ".";          // --work-dir=DIR, where the generations are streamed to
+    const char* input = nullptr;         // snapshot to start from instead of a random grid
+    bool check = true;                   // --no-check: don't keep a reference in memory
+    bool wrap = GOL_WRAP;                // torus, fixed by the engine (make WRAP=1)
+    LifeRule rule{GOL_BIRTH, GOL_SURVIVE}; // fixed by the engine (make RULE=B/S)
+};
+
+// Function to parse the streaming testbench command line
+StreamOptions parse_options(int argc, char** argv) {
+    StreamOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (!strncmp(arg, "--rows=", 7)) opts.rows = atoi(arg + 7);
+        else if (!strncmp(arg, "--gens=", 7)) opts.generations = atol(arg + 7);
+        else if (!strncmp(arg, "--seed=", 7)) opts.seed = strtoull(arg + 7, nullptr, 0);
+        else if (!strncmp(arg, "--density=", 10)) opts.density = atof(arg + 10);
+        else if (!strncmp(arg, "--work-dir=", 11)) opts.work_dir = arg + 11;
+        else if (!strcmp(arg, "--no-check")) opts.check = false;
+        else if (arg[0] == '-' && arg[1] == '-') {
+            cerr << "Unknown option " << arg << endl;
+            exit(EXIT_FAILURE);
+        }
+        else if (arg[0] != '+') opts.input = arg;
+    }
+    if (opts.rows < 1 || opts.generations < 0 || opts.density < 0 || opts.density > 1) {
+        cerr << "--rows must be at least 1, --gens must not be negative and --density must be in [0, 1]" << endl;
+        exit(EXIT_FAILURE);
+    }
+    return opts;
+}
+
+// Function to apply one rising clock edge
+static void clock_edge(VGOLStream* dut) {
+    dut->clock = 1;
+    dut->eval();
+    dut->clock = 0;
+    dut->eval();
+}
+
+// Function to drive one packed grid row onto RowIn
+static void set_row_in(VGOLStream* dut, const uint64_t* row) {
+#if GOL_STREAM_COLS > 64
+    // Ports wider than 64 bits are exposed by Verilator as an array of 32-bit words
+    for (int w = 0; w < (GOL_STREAM_COLS + 31) / 32; ++w) dut->RowIn[w] = uint32_t(row[w >> 1] >> (32 * (w & 1)));
+#else
+    dut->RowIn = row[0];
+#endif
+}
+
+// Function to read RowOut into one packed grid row
+static void get_row_out(VGOLStream* dut, uint64_t* row) {
+#if GOL_STREAM_COLS > 64
+    for (int w = 0; w < (GOL_STREAM_COLS + 31) / 32; ++w) {
+        if (w & 1) row[w >> 1] |= uint64_t(dut->RowOut[w]) << 32;
+        else row[w >> 1] = dut->RowOut[w];
+    }
+#else
+    row[0] = dut->RowOut;
+#endif
+}
+
+// Function to stream one generation through the engine, straight from the mapped input snapshot into the mapped
+// output one. After row k is given, RowOut is the next generation of row k-1. The rows before the first and after
+// the last are the dead guard rows, or for a torus the last and first row (whose output before row 0 is dropped).
+// Returns false if the engine doesn't produce a row when it should.
+static bool stream_pass(VGOLStream* dut, const MappedSnapshot& in, SnapshotWriter& out, bool wrap) {
+    int rows = in.rows();
+    dut->Start = 1;
+    clock_edge(dut);
+    dut->Start = 0;
+
+    dut->RowValid = 1;
+    for (int k = wrap ? -1 : 0; k <= rows; ++k) {
+        set_row_in(dut, in.row(wrap ? (k + rows) % rows : k));
+        clock_edge(dut);
+        if (k < 1) continue;
+        if (!dut->RowOutValid) {
+            dut->RowValid = 0;
+            return false;
+        }
+        get_row_out(dut, out.row(k - 1));
+    }
+    dut->RowValid = 0;
+    return true;
+}
+
+// Line-buffer streaming testbench: the grid lives in snapshot files, and each generation is one pass of every row
+// from one memory-mapped file through GOLStream into the next (work_dir/stream_0.golsnap and stream_1.golsnap take
+// turns), so the grid size is bounded by the disk rather than by the Verilated model. Unless --no-check is given,
+// each generation is compared against the packed reference engine.
+int main(int argc, char** argv) {
+    VerilatedContext context;
+    context.commandArgs(argc, argv);
+    StreamOptions opts = parse_options(argc, argv);
+    VGOLStream dut(&context);
+
+    auto stream_path = [&](long gen) { return string(opts.work_dir) + "/stream_" + to_string(gen % 2) + ".golsnap"; };
+    string input_path, error;
+    PackedGrid reference;
+    if (opts.input) {
+        input_path = opts.input;
+        uint64_t generation = 0;
+        if (opts.check && !load_snapshot(input_path, reference, generation, error)) {
+            cerr << error << endl;
+            return EXIT_FAILURE;
+        }
+    } else {
+        input_path = stream_path(0);
+        reference = random_grid(opts.rows, GOL_STREAM_COLS, opts.seed, opts.density);
+        if (!save_snapshot(input_path, reference, 0, error)) {
+            cerr << error << endl;
+            return EXIT_FAILURE;
+        }
+        if (!opts.check) reference = PackedGrid();
+    }
+
+    PackedGrid next(reference.rows, reference.cols);
+    long rows_streamed = 0, failed = 0;
+    double seconds = 0;
+    for (long gen = 1; gen <= opts.generations && !failed; ++gen) {
+        // Each pass reads the previous generation's file and writes the other one
+        const string& in_path = gen == 1 ? input_path : stream_path(gen - 1);
+        MappedSnapshot in;
+        if (!in.open(in_path, error)) {
+            cerr << error << endl;
+            return EXIT_FAILURE;
+        }
+        if (in.cols() != GOL_STREAM_COLS) {
+            cerr << in_path << " holds " << in.cols() << " columns, the engine was built for " << GOL_STREAM_COLS
+                 << " (make STREAM_COLS=" << in.cols() << ")" << endl;
+            return EXIT_FAILURE;
+        }
+        SnapshotWriter out;
+        if (!out.create(stream_path(gen), in.rows(), in.cols(), in.generation() + 1, error)) {
+            cerr << error << endl;
+            return EXIT_FAILURE;
+        }
+
+        auto start = chrono::steady_clock::now();
+        bool streamed_ok = stream_pass(&dut, in, out, opts.wrap);
+        seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        rows_streamed += in.rows();
+        if (!out.finish(error)) {
+            cerr << error << endl;
+            return EXIT_FAILURE;
+        }
+        if (!streamed_ok) {
+            cout << "ERROR on generation " << gen << ": RowOutValid missing" << endl;
+            failed++;
+            break;
+        }
+
+        if (opts.check) {
+            calc_packed_state(reference, next, opts.wrap, opts.rule);
+            swap(reference, next);
+            // Compared in place in the mapping, the streamed generation is never copied
+            MappedSnapshot streamed;
+            if (!streamed.open(stream_path(gen), error)) {
+                cerr << error << endl;
+                return EXIT_FAILURE;
+            }
+            int row = 0, col = 0;
+            long cells = first_difference_rows(reference, streamed.row(0), streamed.header().stride, row, col);
+            if (cells) {
+                cout << "ERROR on generation " << gen << ": cell (" << row << ", " << col << ") should be "
+                     << (reference.get(row, col) ? "alive" : "dead") << ", " << cells << " cell(s) differ" << endl;
+                failed++;
+            }
+        }
+    }
+    dut.final();
+
+    double cells = double(rows_streamed) * GOL_STREAM_COLS;
+    cout << "Streamed " << opts.generations << " generation(s) of " << GOL_STREAM_COLS << "-column rows: "
+         << rows_streamed << " rows in " << seconds << " s, " << rows_streamed / seconds << " rows/s, "
+         << cells / seconds << " cells/s" << endl;
+    if (opts.generations > 0) cout << "Last generation in " << stream_path(opts.generations) << endl;
+    if (opts.check) cout << (failed ? "FAILED" : "PASSED") << " against the reference engine" << endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
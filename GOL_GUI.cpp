@@ -4,46 +4,316 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/Window.hpp>
 #include <SFML/System.hpp>
+#include <string.h>
+#include <cmath>
+#include <string>
+#include "GOL_GUI.h"
+#include "GOL_snapshot.h"
 
 using namespace std;
 
+// Cell colors, blended over the white background
+static const sf::Uint8 alive_rgba[4] = {0, 255, 75, 150};
+static const sf::Uint8 dead_rgba[4] = {200, 0, 0, 150};
+
+// Function to show the whole grid centered in the window. Cells are a whole number of pixels when they are at least
+// one pixel.
+void GridRenderer::fit() {
+    fit_to_window = true;
+    if (!rows || !cols || !window_size.x || !window_size.y) return;
+    pixels_per_cell = std::min(float(window_size.x) / cols, float(window_size.y) / rows);
+    if (pixels_per_cell >= 1) pixels_per_cell = std::floor(pixels_per_cell);
+    center_x = cols / 2.0f;
+    center_y = rows / 2.0f;
+}
+
+// Function to zoom by the given factor while keeping the grid position under window pixel (x, y) in place. Zooming
+// out stops at half the fitted size, zooming in at 256 pixels per cell.
+void GridRenderer::zoom(float factor, int x, int y) {
+    if (!rows || !cols || !window_size.x || !window_size.y) return;
+    float fitted = std::min(float(window_size.x) / cols, float(window_size.y) / rows);
+    float new_scale = std::max(fitted / 2, std::min(256.0f, pixels_per_cell * factor));
+    float dx = x - window_size.x / 2.0f;
+    float dy = y - window_size.y / 2.0f;
+    center_x += dx / pixels_per_cell - dx / new_scale;
+    center_y += dy / pixels_per_cell - dy / new_scale;
+    pixels_per_cell = new_scale;
+    fit_to_window = false;
+    pan(0, 0);
+}
+
+// Function to drag the grid by (dx, dy) window pixels. The window center always stays over the grid; on a torus it
+// wraps around to the opposite side instead.
+void GridRenderer::pan(int dx, int dy) {
+    center_x -= dx / pixels_per_cell;
+    center_y -= dy / pixels_per_cell;
+    if (wrap && rows && cols) {
+        center_x -= std::floor(center_x / cols) * cols;
+        center_y -= std::floor(center_y / rows) * rows;
+    } else {
+        center_x = std::max(0.0f, std::min(float(cols), center_x));
+        center_y = std::max(0.0f, std::min(float(rows), center_y));
+    }
+    if (dx || dy) fit_to_window = false;
+}
+
+// Function to follow the window size. The camera is refitted on resize until the user zooms or pans.
+void GridRenderer::layout(const sf::RenderWindow& window) {
+    sf::Vector2u size = window.getSize();
+    if (size.x == window_size.x && size.y == window_size.y) return;
+    window_size = size;
+    if (fit_to_window) fit();
+}
+
+// Function to draw the game state through the camera. The window's own view (used for the buttons) is restored
+// afterwards.
+void GridRenderer::draw(sf::RenderWindow& window, const PackedGrid& game_state) {
+    if (game_state.rows != rows || game_state.cols != cols) {
+        rows = game_state.rows;
+        cols = game_state.cols;
+        if (fit_to_window) fit();
+
+        // Grids larger than the largest texture are always drawn through the density map
+        unsigned int max_size = sf::Texture::getMaximumSize();
+        texture_ok = unsigned(cols) <= max_size && unsigned(rows) <= max_size && texture.create(cols, rows);
+        if (texture_ok) {
+            texture.setSmooth(false); // nearest-neighbor scaling keeps the cells sharp
+            sprite.setTexture(texture, true);
+
+            // Start from an all-dead texture, draw_cells() fills in the rest
+            shown = PackedGrid(rows, cols);
+            pixels.resize(size_t(rows) * cols * 4);
+            for (size_t px = 0; px < pixels.size(); px += 4) memcpy(&pixels[px], dead_rgba, 4);
+            texture.update(pixels.data());
+        } else {
+            shown = PackedGrid();
+            vector<sf::Uint8>().swap(pixels);
+        }
+        lines_scale = 0;
+    }
+    if (!rows || !cols || !window_size.x || !window_size.y) return;
+
+    float view_width = window_size.x / pixels_per_cell;
+    float view_height = window_size.y / pixels_per_cell;
+    sf::View ui_view = window.getView();
+    window.setView(sf::View(sf::Vector2f(center_x, center_y), sf::Vector2f(view_width, view_height)));
+
+    // Visible range [vc0, vc1) x [vr0, vr1), which on a torus may reach into copies of the grid (copy (cx, cy) is the
+    // grid shifted by cx*cols, cy*rows). Without wrap only copy (0, 0) exists.
+    int vc0 = int(std::floor(center_x - view_width / 2)), vc1 = int(std::ceil(center_x + view_width / 2));
+    int vr0 = int(std::floor(center_y - view_height / 2)), vr1 = int(std::ceil(center_y + view_height / 2));
+    auto floor_div = [](int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); };
+    int cx0 = wrap ? floor_div(vc0, cols) : 0, cx1 = wrap ? floor_div(vc1 - 1, cols) : 0;
+    int cy0 = wrap ? floor_div(vr0, rows) : 0, cy1 = wrap ? floor_div(vr1 - 1, rows) : 0;
+    bool visible = false;
+    for (int cy = cy0; cy <= cy1; ++cy) {
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            // Visible cell range [c0, c1) x [r0, r1) of this copy, in grid coordinates
+            int c0 = std::max(0, vc0 - cx * cols), c1 = std::min(cols, vc1 - cx * cols);
+            int r0 = std::max(0, vr0 - cy * rows), r1 = std::min(rows, vr1 - cy * rows);
+            if (c0 >= c1 || r0 >= r1) continue;
+            visible = true;
+            sf::Transform offset;
+            offset.translate(float(cx * cols), float(cy * rows));
+            sf::RenderStates states(offset);
+            if (texture_ok && pixels_per_cell >= 1) draw_cells(window, states, game_state, c0, c1, r0, r1);
+            else draw_density(window, states, game_state, c0, c1, r0, r1);
+        }
+    }
+
+    // Cell outlines (skipped when cells are too small to see them), over the whole view on a torus
+    if (visible && pixels_per_cell >= 4) {
+        if (wrap) build_lines(vc0, vc1, vr0, vr1);
+        else build_lines(std::max(0, vc0), std::min(cols, vc1), std::max(0, vr0), std::min(rows, vr1));
+        window.draw(lines);
+    }
+    window.setView(ui_view);
+}
+
+// Function to copy the visible part of a game state into the cell texture and draw it. Only the words that differ
+// from the state already in the texture are expanded into pixels, and only the band of rows that contains changes is
+// uploaded. Words outside the view keep their old contents until they are scrolled into view.
+void GridRenderer::draw_cells(sf::RenderWindow& window, const sf::RenderStates& states, const PackedGrid& game_state,
+                              int c0, int c1, int r0, int r1) {
+    int first_row = rows, last_row = -1;
+    for (int i = r0; i < r1; ++i) {
+        const uint64_t* row = game_state.row(i);
+        uint64_t* shown_row = shown.row(i);
+        for (int w = c0 >> 6; w < (c1 + 63) >> 6; ++w) {
+            if (!(row[w] ^ shown_row[w])) continue;
+            first_row = std::min(first_row, i);
+            last_row = i;
+            shown_row[w] = row[w];
+
+            // Expand the changed word into its (up to) 64 pixels
+            int last_col = std::min(cols, 64 * (w + 1));
+            sf::Uint8* px = &pixels[(size_t(i) * cols + 64 * w) * 4];
+            for (int j = 64 * w; j < last_col; ++j, px += 4) {
+                memcpy(px, (row[w] >> (j & 63)) & 1 ? alive_rgba : dead_rgba, 4);
+            }
+        }
+    }
+    if (last_row >= 0) {
+        texture.update(&pixels[size_t(first_row) * cols * 4], cols, last_row - first_row + 1, 0, first_row);
+    }
+    window.draw(sprite, states);
+}
+
+// Function to draw the visible part of a game state as a density map. Each texel covers a block of cells (the
+// smallest power of two that is at least one pixel wide) and is blended from the dead to the alive color by the
+// fraction of live cells in the block. Populations are popcounts of the packed words, so a block costs a few
+// instructions per 64 cells.
+void GridRenderer::draw_density(sf::RenderWindow& window, const sf::RenderStates& states, const PackedGrid& game_state,
+                                int c0, int c1, int r0, int r1) {
+    int block = 1;
+    while (block * pixels_per_cell < 1) block *= 2;
+
+    int bc0 = c0 / block, bc1 = (c1 + block - 1) / block;
+    int br0 = r0 / block, br1 = (r1 + block - 1) / block;
+    int width = bc1 - bc0, height = br1 - br0;
+    int w0 = (bc0 * block) >> 6, w1 = (std::min(cols, bc1 * block) + 63) >> 6;
+    uint64_t block_mask = block >= 64 ? ~uint64_t(0) : (uint64_t(1) << block) - 1;
+    density_pixels.resize(size_t(width) * height * 4);
+
+    for (int br = br0; br < br1; ++br) {
+        block_counts.assign(width, 0);
+        int row_end = std::min(rows, (br + 1) * block);
+        for (int i = br * block; i < row_end; ++i) {
+            const uint64_t* row = game_state.row(i);
+            for (int w = w0; w < w1; ++w) {
+                uint64_t word = row[w];
+                if (!word) continue;
+                if (block >= 64) {
+                    // The whole word falls inside one block
+                    block_counts[(64 * w) / block - bc0] += __builtin_popcountll(word);
+                    continue;
+                }
+                for (int k = 0; k < 64; k += block) {
+                    int b = (64 * w + k) / block - bc0;
+                    if (b >= 0 && b < width) block_counts[b] += __builtin_popcountll((word >> k) & block_mask);
+                }
+            }
+        }
+
+        // Blocks on the right and bottom edges may be cut off by the grid boundary
+        sf::Uint8* px = &density_pixels[size_t(br - br0) * width * 4];
+        for (int b = 0; b < width; ++b, px += 4) {
+            int col_end = std::min(cols, (bc0 + b + 1) * block);
+            float density = float(block_counts[b]) / (float(row_end - br * block) * (col_end - (bc0 + b) * block));
+            for (int c = 0; c < 4; ++c) px[c] = sf::Uint8(dead_rgba[c] + (alive_rgba[c] - dead_rgba[c]) * density + 0.5f);
+        }
+    }
+
+    // The texture only grows, so panning does not reallocate it every frame
+    sf::Vector2u size = density_texture.getSize();
+    if (unsigned(width) > size.x || unsigned(height) > size.y) {
+        density_texture.create(std::max(unsigned(width), size.x), std::max(unsigned(height), size.y));
+        density_texture.setSmooth(false);
+    }
+    density_texture.update(density_pixels.data(), width, height, 0, 0);
+    density_sprite.setTexture(density_texture);
+    density_sprite.setTextureRect(sf::IntRect(0, 0, width, height));
+    density_sprite.setPosition(float(bc0 * block), float(br0 * block));
+    density_sprite.setScale(float(block), float(block));
+    window.draw(density_sprite, states);
+}
+
+// Function to build the cell outlines over the visible range as thin black quads (1 or 2 pixels wide). Rebuilt only
+// when the visible range or zoom changes.
+void GridRenderer::build_lines(int c0, int c1, int r0, int r1) {
+    if (lines_scale == pixels_per_cell && lines_key[0] == c0 && lines_key[1] == c1 && lines_key[2] == r0 && lines_key[3] == r1) return;
+    lines_scale = pixels_per_cell;
+    lines_key[0] = c0;
+    lines_key[1] = c1;
+    lines_key[2] = r0;
+    lines_key[3] = r1;
+
+    lines.clear();
+    float half = (pixels_per_cell >= 8 ? 2 : 1) / pixels_per_cell / 2;
+    auto add_quad = [&](float x0, float y0, float x1, float y1) {
+        lines.append(sf::Vertex(sf::Vector2f(x0, y0), sf::Color::Black));
+        lines.append(sf::Vertex(sf::Vector2f(x1, y0), sf::Color::Black));
+        lines.append(sf::Vertex(sf::Vector2f(x1, y1), sf::Color::Black));
+        lines.append(sf::Vertex(sf::Vector2f(x0, y1), sf::Color::Black));
+    };
+    for (int j = c0; j <= c1; ++j) add_quad(j - half, r0 - half, j + half, r1 + half);
+    for (int i = r0; i <= r1; ++i) add_quad(c0 - half, i - half, c1 + half, i + half);
+}
+
+void StatsGraph::draw(sf::RenderWindow& window, const sf::Font& font, const GenerationStats* samples, size_t n,
+                      size_t current) {
+    if (!n) return;
+    sf::Vector2u size = window.getSize();
+    float width = std::min(300.0f, size.x * 0.3f), height = std::min(120.0f, size.y * 0.2f);
+    float x0 = 20, y0 = size.y - height - 90;
+    background.setSize(sf::Vector2f(width, height));
+    background.setPosition(x0, y0);
+    background.setFillColor(sf::Color(255, 255, 255, 200));
+    background.setOutlineColor(sf::Color::Black);
+    background.setOutlineThickness(1);
+
+    // One point per pixel column at most
+    size_t points = std::min(n, size_t(std::max(1.0f, width)));
+    auto sample = [&](size_t k) -> const GenerationStats& {
+        return samples[points > 1 ? k * (n - 1) / (points - 1) : 0];
+    };
+    int64_t max_population = 1, max_change = 1;
+    for (size_t k = 0; k < points; ++k) {
+        max_population = std::max(max_population, sample(k).population);
+        max_change = std::max(max_change, std::max(sample(k).births, sample(k).deaths));
+    }
+    auto point = [&](size_t k, int64_t value, int64_t scale) {
+        float x = x0 + (points > 1 ? width * k / (points - 1) : width / 2);
+        return sf::Vector2f(x, y0 + height - height * value / scale);
+    };
+    population.resize(points);
+    births.resize(points);
+    deaths.resize(points);
+    for (size_t k = 0; k < points; ++k) {
+        population[k] = sf::Vertex(point(k, sample(k).population, max_population), sf::Color{0, 90, 255});
+        births[k] = sf::Vertex(point(k, sample(k).births, max_change), sf::Color{0, 170, 60});
+        deaths[k] = sf::Vertex(point(k, sample(k).deaths, max_change), sf::Color{220, 0, 0});
+    }
+    float mx = x0 + (n > 1 ? width * std::min(current, n - 1) / (n - 1) : width / 2);
+    marker[0] = sf::Vertex(sf::Vector2f(mx, y0), sf::Color::Black);
+    marker[1] = sf::Vertex(sf::Vector2f(mx, y0 + height), sf::Color::Black);
+
+    const GenerationStats& s = samples[std::min(current, n - 1)];
+    string text = "gen " + to_string(s.generation) + "  pop " + to_string(s.population) + "  +" + to_string(s.births)
+                + " -" + to_string(s.deaths);
+    if (s.population) {
+        text += "  box " + to_string(s.max_row - s.min_row + 1) + "x" + to_string(s.max_col - s.min_col + 1);
+    }
+    label.setFont(font);
+    label.setCharacterSize(14);
+    label.setFillColor(sf::Color::Black);
+    label.setString(text);
+    label.setPosition(x0, y0 - 20);
+
+    window.draw(background);
+    window.draw(population);
+    window.draw(births);
+    window.draw(deaths);
+    window.draw(marker);
+    window.draw(label);
+}
+
 // Function to render the game state grid using SFML
-void render_grid(const vector<vector<bool>>& game_state, sf::RenderWindow& window, int cell_size = 30) {
+void render_grid(const PackedGrid& game_state, sf::RenderWindow& window, GridRenderer& renderer) {
     // Clear the window with white color
     window.clear(sf::Color::White);
 
-    // Get window size
-    int window_width = window.getSize().x;
-    int window_height = window.getSize().y;
-
-    // Calculate the cell size dynamically to fit the window
-    int grid_columns = game_state[0].size();
-    int grid_rows = game_state.size();
-    int dynamic_cell_size = std::min(window_width / grid_columns, window_height / grid_rows);
-
-    // Calculate the total size of the grid
-    int grid_width = grid_columns * dynamic_cell_size;
-    int grid_height = grid_rows * dynamic_cell_size;
-
-    // Calculate the position to center the grid
-    int offset_x = (window_width - grid_width) / 2;
-    int offset_y = (window_height - grid_height) / 2;
-
-    // Draw each cell of the grid
-    for (int i = 0; i < game_state.size(); ++i) {
-        for (int j = 0; j < game_state[0].size(); ++j) {
-            sf::RectangleShape cell(sf::Vector2f(dynamic_cell_size, dynamic_cell_size));
-            cell.setPosition(offset_x + j * dynamic_cell_size, offset_y + i * dynamic_cell_size);
-            cell.setFillColor(game_state[i][j] ? sf::Color{0, 255, 75, 150} : sf::Color{200, 0, 0, 150});
-            cell.setOutlineColor(sf::Color::Black); // Cell outline color
-            cell.setOutlineThickness(2); // Cell outline thickness
-            window.draw(cell);
-        }
-    }
+    renderer.layout(window);
+    renderer.draw(window, game_state);
 }
 
-// Function to cycle through game states with a button press in the UI
-int cycle_game_states(const vector<vector<vector<bool>>>& game_states) {
+// Function to run the UI, either over a recorded history (game_states) or over a live simulation (live).
+// With a history, the "Calc Next Iteration" button and the Right arrow key step forwards and Left steps backwards.
+// Live, they ask the simulation for the next generation instead; holding the button requests one every pace
+// interval, or with the slider at the top lets the simulation run freely and shows the newest generation each frame.
+// The mouse wheel zooms around the cursor, dragging with the right mouse button pans and F fits the whole grid back
+// into the window. G shows or hides the stats graph.
+static int run_gui(const GameHistory* game_states, LiveStream* live, bool wrap) {
     // Create a window
     sf::RenderWindow window(sf::VideoMode(800, 800), "Game of Life", sf::Style::Close | sf::Style::Resize);
 
@@ -98,19 +368,48 @@ int cycle_game_states(const vector<vector<vector<bool>>>& game_states) {
     centerText(coolbuttonText, cool_button);
 
     int current_state_index = 0;
+    PackedGrid current_state = live ? PackedGrid() : PackedGrid(game_states->rows(), game_states->cols());
+    LiveFrame live_frame{-1, live ? PackedGrid(live->rows, live->cols) : PackedGrid()};
+    GridRenderer renderer(wrap);
+    StatsGraph graph;
+    bool show_stats = true;
+    // Live, the stats of every received frame (the newest live_samples to 2*live_samples of them)
+    const size_t live_samples = 4096;
+    vector<GenerationStats> live_stats;
     bool isButtonHeld = false;
     sf::Clock holdClock;
     sf::Clock clickClock;
 
     int simulation_pace = 50;
     bool isSliderHeld = false;
+    bool isPanning = false;
+    sf::Vector2i panFrom;
+
+    // Function to advance one generation
+    auto step_forward = [&]() {
+        if (live) {
+            live->request();
+            return;
+        }
+        current_state_index++;
+        if (current_state_index >= game_states->size()) {
+            current_state_index = 0;
+        }
+    };
 
+    // The window is only redrawn when something visible changed (state index, window size, slider, camera), and never
+    // more than 60 times a second. When nothing is animating the loop sleeps in waitEvent instead of spinning.
+    bool redraw = true;
+    int shown_state_index = -1;
+    window.setFramerateLimit(60);
 
     // Main UI loop
     while (window.isOpen()) {
         sf::Event event;
 
-        while (window.pollEvent(event)) {
+        bool live_pending = live && live->pending(live_frame.generation);
+        bool have_event = (isButtonHeld || redraw || live_pending) ? window.pollEvent(event) : window.waitEvent(event);
+        for (; have_event; have_event = window.pollEvent(event)) {
             if (event.type == sf::Event::Closed) {
                 window.close();
                 return 0;
@@ -137,17 +436,66 @@ int cycle_game_states(const vector<vector<vector<bool>>>& game_states) {
                 }
             }
 
+            // Camera controls
+            if (event.type == sf::Event::MouseWheelScrolled && event.mouseWheelScroll.wheel == sf::Mouse::VerticalWheel) {
+                renderer.zoom(std::pow(1.25f, event.mouseWheelScroll.delta), event.mouseWheelScroll.x, event.mouseWheelScroll.y);
+                redraw = true;
+            }
+            if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Right) {
+                isPanning = true;
+                panFrom = sf::Vector2i(event.mouseButton.x, event.mouseButton.y);
+            }
+            if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Right) {
+                isPanning = false;
+            }
+            if (event.type == sf::Event::MouseMoved && isPanning) {
+                renderer.pan(event.mouseMove.x - panFrom.x, event.mouseMove.y - panFrom.y);
+                panFrom = sf::Vector2i(event.mouseMove.x, event.mouseMove.y);
+                redraw = true;
+            }
+
             if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left) {
                 isSliderHeld = false;
                 if (iter_button.getGlobalBounds().contains(event.mouseButton.x, event.mouseButton.y)) {
                     isButtonHeld = false;
+                    if (live) live->set_run_free(false);
                     if (clickClock.getElapsedTime().asMilliseconds() < 500) {
                         // if button was held for less than 500 ms, it was a click rather than a hold, update state
                         // by one iteration.
-                        current_state_index++;
-                        if (current_state_index >= game_states.size()) {
-                            current_state_index = 0;
+                        step_forward();
+                    }
+                }
+            }
+
+            if (event.type == sf::Event::KeyPressed) {
+                // Step through the history (holding a key repeats)
+                if (event.key.code == sf::Keyboard::Right) {
+                    step_forward();
+                }
+                else if (event.key.code == sf::Keyboard::Left && !live) {
+                    current_state_index--;
+                    if (current_state_index < 0) {
+                        current_state_index = game_states->size() - 1;
+                    }
+                }
+                else if (event.key.code == sf::Keyboard::F) {
+                    renderer.fit();
+                    redraw = true;
+                }
+                else if (event.key.code == sf::Keyboard::G) {
+                    show_stats = !show_stats;
+                    redraw = true;
+                }
+                else if (event.key.code == sf::Keyboard::S) {
+                    // Save the generation on screen as a snapshot (--resume=FILE starts a test from it)
+                    long gen = live ? live_frame.generation : current_state_index;
+                    if (!live) game_states->get(current_state_index, current_state);
+                    string path = "snapshot_g" + to_string(gen) + ".golsnap", error;
+                    if (gen >= 0) {
+                        if (save_snapshot(path, live ? live_frame.grid : current_state, gen, error)) {
+                            cout << "Saved " << path << endl;
                         }
+                        else cerr << error << endl;
                     }
                 }
             }
@@ -184,6 +532,11 @@ int cycle_game_states(const vector<vector<vector<bool>>>& game_states) {
                 centerText(iterbuttonText, iter_button);
                 centerText(nextbuttonText, next_button);
                 centerText(coolbuttonText, cool_button);
+                redraw = true;
+            }
+
+            if (event.type == sf::Event::GainedFocus) {
+                redraw = true;
             }
 
             if (event.type == sf::Event::MouseMoved && isSliderHeld) {
@@ -192,21 +545,54 @@ int cycle_game_states(const vector<vector<vector<bool>>>& game_states) {
                 slider_thumb.setPosition(window.getSize().x - 35, new_y);
 
                 float position_ratio = static_cast<float>(new_y - 100) / (300);
-                simulation_pace = 20 + static_cast<int>(position_ratio * (500 - 20));
+                simulation_pace = static_cast<int>(position_ratio * 500); // 0 at the top: as fast as possible
+                redraw = true;
             }
 
         }
 
-        if (isButtonHeld && clickClock.getElapsedTime().asMilliseconds() >= 500 && holdClock.getElapsedTime().asMilliseconds() >= simulation_pace) {
-            current_state_index++;
-            if (current_state_index >= game_states.size()) {
-                current_state_index = 0;
+        if (isButtonHeld && clickClock.getElapsedTime().asMilliseconds() >= 500) {
+            if (live && simulation_pace == 0) live->set_run_free(true);
+            else if (holdClock.getElapsedTime().asMilliseconds() >= simulation_pace) {
+                step_forward();
+                holdClock.restart();
             }
-            holdClock.restart();
         }
 
+        if (live) {
+            // Take everything the simulation has produced and keep only the newest generation (and every stats sample)
+            long received = live_frame.generation;
+            while (live->frames.try_pop(live_frame)) live_stats.push_back(live_frame.stats);
+            if (live_stats.size() > 2 * live_samples) {
+                live_stats.erase(live_stats.begin(), live_stats.end() - live_samples);
+            }
+            if (live_frame.generation != received) {
+                window.setTitle("Game of Life - generation " + std::to_string(live_frame.generation));
+                redraw = true;
+            }
+        }
+        else if (current_state_index != shown_state_index) redraw = true;
+        if (!redraw) {
+            // The button is held but the next step isn't due yet: sleep until it is, but wake up at least every 10 ms
+            // so a release is still seen in time to count as a click. Live, also poll for the next frame.
+            if (isButtonHeld) {
+                int until_hold = 500 - clickClock.getElapsedTime().asMilliseconds();
+                int until_step = simulation_pace - holdClock.getElapsedTime().asMilliseconds();
+                sf::sleep(sf::milliseconds(std::min(10, std::max(1, std::max(until_hold, until_step)))));
+            }
+            else if (live_pending) sf::sleep(sf::milliseconds(1));
+            continue;
+        }
+        redraw = false;
+        shown_state_index = current_state_index;
+
         window.clear();
-        render_grid(game_states[current_state_index], window); // Render the current game state
+        if (!live) game_states->get(current_state_index, current_state);
+        render_grid(live ? live_frame.grid : current_state, window, renderer); // Render the current game state
+        if (show_stats && live) graph.draw(window, font, live_stats.data(), live_stats.size(), live_stats.size() - 1);
+        else if (show_stats) {
+            graph.draw(window, font, game_states->stats().data(), game_states->stats().size(), current_state_index);
+        }
         window.draw(iter_button);
         window.draw(iterbuttonText);
         window.draw(next_button);
@@ -219,4 +605,12 @@ int cycle_game_states(const vector<vector<vector<bool>>>& game_states) {
     }
 
     return 1;
-}
\ No newline at end of file
+}
+
+int cycle_game_states(const GameHistory& game_states, bool wrap) {
+    return run_gui(&game_states, nullptr, wrap);
+}
+
+int stream_game_states(LiveStream& live, bool wrap) {
+    return run_gui(nullptr, &live, wrap);
+}
@@ -2,8 +2,84 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/Window.hpp>
 #include <SFML/System.hpp>
+#include "GOL_history.h"
+#include "GOL_stream.h"
+#include "GOL_stats.h"
 
 using namespace std;
 
-void render_grid(const vector<vector<bool>>& game_state, sf::RenderWindow& window, int cell_size = 30);
-int cycle_game_states(const vector<vector<vector<bool>>>& game_states);
+// Draws a game state through a zoomable, pannable camera (an sf::View in cell coordinates) with a constant number of
+// draw calls. Only the part of the grid inside the view is touched each frame.
+//  - At one or more pixels per cell, the cells live in a texture with one texel per cell, shown as a single sprite
+//    with nearest-neighbor sampling. Only visible words that changed since the last frame are re-expanded into
+//    pixels, and the grid lines are a separate vertex array rebuilt only when the camera moves.
+//  - Below one pixel per cell (or if the grid is larger than the GPU's largest texture), the visible region is drawn
+//    as a density map instead: one texel per block of cells, colored by the block's live-cell count.
+// For a torus (wrap) the grid repeats in every direction, so panning never hits an edge: each copy of the grid that
+// overlaps the view is drawn with its own translation.
+class GridRenderer {
+public:
+    explicit GridRenderer(bool wrap = false) : wrap(wrap) {}
+
+    void fit();                                   // show the whole grid, centered
+    void zoom(float factor, int x, int y);        // zoom around window pixel (x, y)
+    void pan(int dx, int dy);                     // move the grid by (dx, dy) window pixels
+    void layout(const sf::RenderWindow& window);
+    void draw(sf::RenderWindow& window, const PackedGrid& game_state);
+
+private:
+    void draw_cells(sf::RenderWindow& window, const sf::RenderStates& states, const PackedGrid& game_state,
+                    int c0, int c1, int r0, int r1);
+    void draw_density(sf::RenderWindow& window, const sf::RenderStates& states, const PackedGrid& game_state,
+                      int c0, int c1, int r0, int r1);
+    void build_lines(int c0, int c1, int r0, int r1);
+
+    bool wrap;
+    int rows = 0;
+    int cols = 0;
+
+    // Camera: grid position at the center of the window and window pixels per cell
+    float center_x = 0;
+    float center_y = 0;
+    float pixels_per_cell = 1;
+    bool fit_to_window = true;                    // refit when the window is resized
+    sf::Vector2u window_size{0, 0};
+
+    // Cell mode
+    bool texture_ok = false;
+    PackedGrid shown;                             // game state currently held by the texture
+    vector<sf::Uint8> pixels;                     // RGBA, one pixel per cell
+    sf::Texture texture;
+    sf::Sprite sprite;
+    sf::VertexArray lines{sf::Quads};
+    int lines_key[4] = {-1, -1, -1, -1};          // visible range the lines were built for
+    float lines_scale = 0;
+
+    // Density mode
+    vector<uint32_t> block_counts;
+    vector<sf::Uint8> density_pixels;
+    sf::Texture density_texture;
+    sf::Sprite density_sprite;
+};
+
+// Overlay graph of the stats of the generations shown so far, in the bottom-left corner of the window: population
+// (blue) on one scale and births (green) and deaths (red) on another, with the values of the generation on screen
+// printed above it. Long series are reduced to one sample per pixel column, so a frame costs at most a few hundred
+// vertices however long the run.
+class StatsGraph {
+public:
+    // Draw samples [0, n) with a marker at sample current
+    void draw(sf::RenderWindow& window, const sf::Font& font, const GenerationStats* samples, size_t n, size_t current);
+
+private:
+    sf::RectangleShape background;
+    sf::VertexArray population{sf::LineStrip};
+    sf::VertexArray births{sf::LineStrip};
+    sf::VertexArray deaths{sf::LineStrip};
+    sf::VertexArray marker{sf::Lines, 2};
+    sf::Text label;
+};
+
+void render_grid(const PackedGrid& game_state, sf::RenderWindow& window, GridRenderer& renderer);
+int cycle_game_states(const GameHistory& game_states, bool wrap = false);
+int stream_game_states(LiveStream& live, bool wrap = false);
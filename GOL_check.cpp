@@ -0,0 +1,104 @@
+#include <vector>
+#include "GOL_check.h"
+#include "GOL_hashlife.h"
+#include "GOL_profile.h"
+
+using namespace std;
+
+ReferenceChecker::ReferenceChecker(const PackedGrid& initial_state, function<void(const Mismatch&)> report,
+                                   bool use_tiles, bool wrap, const LifeRule& rule, size_t max_queued)
+    : rows(initial_state.rows), cols(initial_state.cols), wrap(wrap), rule(rule), report(move(report)),
+      max_queued(max_queued) {
+    if (use_tiles) {
+        tiles.reset(new TileEngine(initial_state, wrap, rule));
+        stats.tiles = tiles->tile_count();
+    } else {
+        expected = initial_state.clone();
+        next = PackedGrid(rows, cols);
+    }
+    worker = thread(&ReferenceChecker::run, this);
+}
+
+ReferenceChecker::~ReferenceChecker() {
+    {
+        lock_guard<mutex> lock(m);
+        stopping = true;
+    }
+    work_cv.notify_one();
+    worker.join();
+}
+
+void ReferenceChecker::submit(long generation, PackedGrid& dut_state, long steps) {
+    unique_lock<mutex> lock(m);
+    idle_cv.wait(lock, [&] { return queue.size() < max_queued; });
+    queue.push_back(Job{generation, steps < 0 ? generation - submitted_gen : steps, move(dut_state)});
+    submitted_gen = generation;
+
+    // Hand back a buffer the worker is done with (only the first few submits have to allocate one)
+    if (!free_grids.empty()) {
+        dut_state = move(free_grids.back());
+        free_grids.pop_back();
+    } else {
+        dut_state = PackedGrid(rows, cols);
+    }
+    lock.unlock();
+    work_cv.notify_one();
+}
+
+long ReferenceChecker::finish() {
+    unique_lock<mutex> lock(m);
+    idle_cv.wait(lock, [&] { return queue.empty() && !busy; });
+    return mismatches;
+}
+
+TileStats ReferenceChecker::tile_stats() {
+    lock_guard<mutex> lock(m);
+    return stats;
+}
+
+// Worker loop: step the reference to each queued generation and compare it with the DUT
+void ReferenceChecker::run() {
+    unique_lock<mutex> lock(m);
+    for (;;) {
+        work_cv.wait(lock, [&] { return stopping || !queue.empty(); });
+        if (queue.empty()) return;
+        Job job = move(queue.front());
+        queue.pop_front();
+        busy = true;
+        lock.unlock();
+        idle_cv.notify_all();
+
+        GOL_PROFILE_SCOPE(PHASE_REFERENCE);
+        int active = -1;
+        if (tiles && job.steps == 1) {
+            active = tiles->step();
+        } else if (tiles) {
+            jump_packed_state(tiles->mutable_state(), job.steps, wrap, rule);
+            tiles->invalidate();
+        } else if (job.steps == 1) {
+            calc_packed_state(expected, next, wrap, rule);
+            swap(expected, next);
+        } else {
+            jump_packed_state(expected, job.steps, wrap, rule);   // Hashlife for long jumps
+        }
+        const PackedGrid& reference = tiles ? tiles->state() : expected;
+
+        Mismatch mismatch;
+        mismatch.generation = job.generation;
+        mismatch.cells = first_difference(reference, job.grid, mismatch.row, mismatch.col);
+        if (mismatch.cells) {
+            mismatch.expected = reference.get(mismatch.row, mismatch.col);
+            mismatch.dut = &job.grid;
+            mismatch.reference = &reference;
+            if (job.steps == 1) mismatch.previous = tiles ? &tiles->previous_state() : &next;
+            report(mismatch);
+        }
+
+        lock.lock();
+        if (active >= 0) stats.add(active);
+        if (mismatch.cells) mismatches++;
+        free_grids.push_back(move(job.grid));
+        busy = false;
+        idle_cv.notify_all();
+    }
+}
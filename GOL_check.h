@@ -0,0 +1,82 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include "GOL_ref.h"
+#include "GOL_tiles.h"
+
+using namespace std;
+
+// First cell where a DUT generation differs from the reference model
+struct Mismatch {
+    long generation = 0;
+    int row = -1;
+    int col = -1;
+    bool expected = false;           // reference value of that cell
+    long cells = 0;                  // number of differing cells in the generation
+
+    // The states involved, only valid while report runs (e.g. to snapshot them)
+    const PackedGrid* dut = nullptr;
+    const PackedGrid* reference = nullptr;
+    const PackedGrid* previous = nullptr;    // reference one generation earlier (null after a longer jump)
+};
+
+// Checks DUT generations against the packed reference model on a worker thread, so the reference for one generation
+// is computed and compared while the DUT is already evaluating the next ones. Grids move through the queue without
+// being copied: submit() takes the caller's buffer and hands back a recycled one of the same size, so steady-state
+// checking never copies or allocates a grid. Only mismatches come back, through report (called on the worker thread).
+// Single generations are stepped with the packed engine, or with use_tiles with the TileEngine, which skips the
+// settled parts of the grid and keeps count of how much of it was active. With wrap the grid is a torus. Every engine
+// steps the grid under rule.
+class ReferenceChecker {
+public:
+    ReferenceChecker(const PackedGrid& initial_state, function<void(const Mismatch&)> report, bool use_tiles = false,
+                     bool wrap = false, const LifeRule& rule = LifeRule(), size_t max_queued = 4);
+    ~ReferenceChecker();
+    ReferenceChecker(const ReferenceChecker&) = delete;
+    ReferenceChecker& operator=(const ReferenceChecker&) = delete;
+
+    // Queue DUT generation `generation`, which the reference reaches from the previously submitted one (initially
+    // generation 0) in `steps` steps (-1: the difference in generations). Blocks while max_queued generations are
+    // already waiting. dut_state is replaced by a recycled buffer with unspecified contents.
+    void submit(long generation, PackedGrid& dut_state, long steps = -1);
+
+    // Wait until every queued generation has been checked; returns the number of mismatching generations so far
+    long finish();
+
+    // Active tiles per generation (call after finish(); empty without use_tiles)
+    TileStats tile_stats();
+
+private:
+    struct Job {
+        long generation;
+        long steps;
+        PackedGrid grid;
+    };
+    void run();
+
+    int rows, cols;
+    bool wrap;
+    LifeRule rule;
+    PackedGrid expected;             // worker only
+    PackedGrid next;                 // worker only
+    unique_ptr<TileEngine> tiles;    // worker only, holds the expected state instead of expected/next
+    TileStats stats;
+    long submitted_gen = 0;          // submitting thread only
+    function<void(const Mismatch&)> report;
+    size_t max_queued;
+
+    mutex m;
+    condition_variable work_cv;      // wakes the worker: job queued or stopping
+    condition_variable idle_cv;      // wakes submit() / finish(): room in the queue or job done
+    deque<Job> queue;
+    vector<PackedGrid> free_grids;
+    bool busy = false;
+    bool stopping = false;
+    long mismatches = 0;
+    thread worker;
+};
@@ -0,0 +1,260 @@
+#include "VGOL.h"
+#include "VGOL___024root.h"
+#include "VGOLvhdl.h"
+#include "VGOLvhdl___024root.h"
+#include <verilated.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <string.h>
+#include "GOL_ref.h"
+#include "GOL_snapshot.h"
+#include "GOL_random.h"
+
+// Grid size and boundary both models were built with (-Grows, -Gcolumns, -Gwrap for GOL.sv, -grows, -gcolumns, -gwrap
+// for GOL.vhd, see compile-cosim in the Makefile)
+#ifndef GOL_ROWS
+#define GOL_ROWS 30
+#endif
+#ifndef GOL_COLS
+#define GOL_COLS 30
+#endif
+#ifndef GOL_WRAP
+#define GOL_WRAP 0
+#endif
+// The VHDL status signal in the Verilated netlist. GHDL writes VHDL names out in lower case, so the top entity is
+// module gol and its status signal gol.status (made public by GOL-vhdl/GOL.vlt).
+#ifndef GOL_VHDL_STATUS
+#define GOL_VHDL_STATUS gol__DOT__status
+#endif
+
+using namespace std;
+
+// Co-simulation options
+struct CosimOptions {
+    long seeds = 100;                    // --seeds=N, random stimuli
+    uint64_t seed = 0;                   // --seed=S, test i uses seed S+i (random if not given)
+    bool fixed_seed = false;
+    int generations = 200;               // --gens=N, generation limit per stimulus
+    double density = 0.5;                // --density=P
+    const char* snapshot_dir = ".";      // --snapshot-dir=DIR, where diverging states are saved (--no-snapshots)
+    int rows = GOL_ROWS;                 // --grid=ROWSxCOLS, must match the built models
+    int columns = GOL_COLS;
+    bool wrap = GOL_WRAP;
+    LifeRule rule;                       // B3/S23, the only rule the VHDL array implements
+};
+
+// Function to parse the co-simulation command line (Verilator +args are left to the context)
+CosimOptions parse_options(int argc, char** argv) {
+    CosimOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (!strncmp(arg, "--seeds=", 8)) opts.seeds = atol(arg + 8);
+        else if (!strncmp(arg, "--seed=", 7)) {
+            opts.fixed_seed = true;
+            opts.seed = strtoull(arg + 7, nullptr, 0);
+        }
+        else if (!strncmp(arg, "--gens=", 7)) opts.generations = atoi(arg + 7);
+        else if (!strncmp(arg, "--density=", 10)) opts.density = atof(arg + 10);
+        else if (!strncmp(arg, "--snapshot-dir=", 15)) opts.snapshot_dir = arg + 15;
+        else if (!strcmp(arg, "--no-snapshots")) opts.snapshot_dir = nullptr;
+        else if (!strncmp(arg, "--grid=", 7)) sscanf(arg + 7, "%dx%d", &opts.rows, &opts.columns);
+        else if (arg[0] == '-' && arg[1] == '-') {
+            cerr << "Unknown option " << arg << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (opts.rows != GOL_ROWS || opts.columns != GOL_COLS) {
+        cerr << "Models were built for a " << GOL_ROWS << "x" << GOL_COLS << " grid, rebuild with make compile-cosim "
+             << "ROWS=" << opts.rows << " COLS=" << opts.columns << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (!opts.fixed_seed) opts.seed = random_device{}();
+    return opts;
+}
+
+// The SystemVerilog and the VHDL model side by side in one context. Both always see the same inputs and are
+// evaluated on the same edges, so after every clock they should hold the same state.
+struct Cosim {
+    VerilatedContext context;
+    VGOL sv{&context, "sv"};
+    VGOLvhdl vhdl{&context, "vhdl"};
+
+    Cosim(int argc, char** argv) {
+        context.commandArgs(argc, argv);
+        sv.ShiftPar = 0;  // the VHDL array only has the serial port
+        sv.DataInPar = 0;
+        drive(false, false, false);
+        sv.clock = vhdl.clock = 0;
+        sv.eval();
+        vhdl.eval();
+    }
+
+    ~Cosim() {
+        sv.final();
+        vhdl.final();
+    }
+
+    // Function to set the mode inputs of both models (GHDL keeps the VHDL port names, in lower case)
+    void drive(bool shift, bool next_time_tick, bool data_in) {
+        sv.Shift = vhdl.shift = shift;
+        sv.NextTimeTick = vhdl.nexttimetick = next_time_tick;
+        sv.DataIn = vhdl.datain = data_in;
+    }
+
+    // Function to clock both models once (rising and falling edge)
+    void tick() {
+        sv.clock = vhdl.clock = 1;
+        sv.eval();
+        vhdl.eval();
+        sv.clock = vhdl.clock = 0;
+        sv.eval();
+        vhdl.eval();
+    }
+
+    // Function to shift a game state into both arrays through DataIn (bottom-right cell first), then hold a clock
+    void load(const PackedGrid& stimulus) {
+        for (int i = stimulus.rows-1; i >= 0; --i) {
+            for (int j = stimulus.cols-1; j >= 0; --j) {
+                drive(true, false, stimulus.get(i, j));
+                tick();
+            }
+        }
+        drive(false, false, false);
+        tick();
+    }
+
+    // Function to advance both arrays by one generation (NextTimeTick for one clock, then one idle clock)
+    void next_time_tick() {
+        drive(false, true, false);
+        tick();
+        drive(false, false, false);
+        tick();
+    }
+
+    // Function to read both arrays straight from their public status vectors
+    void capture(PackedGrid& sv_state, PackedGrid& vhdl_state) {
+        unpack_flat_cells(&sv.rootp->GOL__DOT__status, sizeof(sv.rootp->GOL__DOT__status), sv_state);
+        unpack_flat_cells(&vhdl.rootp->GOL_VHDL_STATUS, sizeof(vhdl.rootp->GOL_VHDL_STATUS), vhdl_state);
+    }
+};
+
+// Function to say how one model's state compares with the reference
+string versus_reference(const PackedGrid& state, const PackedGrid& reference) {
+    int row = 0, col = 0;
+    long cells = first_difference(state, reference, row, col);
+    if (!cells) return "matches the reference";
+    return "differs from the reference in " + to_string(cells) + " cell(s), first at (" + to_string(row) + ", " +
+           to_string(col) + ")";
+}
+
+// Function to save two states of generation gen as cosim_s<seed>_g<gen>_<a_name>.golsnap and ..._<b_name>.golsnap,
+// along with the state one generation earlier (unless previous is null), which both testbenches can --resume from.
+// Does nothing if snapshot_dir is null.
+void save_cosim_states(const CosimOptions& opts, uint64_t seed, long gen, const PackedGrid& a, const char* a_name,
+                       const PackedGrid& b, const char* b_name, const PackedGrid* previous) {
+    if (!opts.snapshot_dir) return;
+    string base = string(opts.snapshot_dir) + "/cosim_s" + to_string(seed) + "_g", error;
+    string a_path = base + to_string(gen) + "_" + a_name + ".golsnap";
+    string b_path = base + to_string(gen) + "_" + b_name + ".golsnap";
+    string previous_path = base + to_string(gen - 1) + ".golsnap";
+    bool ok = save_snapshot(a_path, a, gen, error) && save_snapshot(b_path, b, gen, error) &&
+              (!previous || save_snapshot(previous_path, *previous, gen - 1, error));
+    if (!ok) cout << "  couldn't save snapshots: " << error << endl;
+    else {
+        cout << "  saved " << a_path << " and " << b_path << endl;
+        if (previous) cout << "  re-run from the generation before with --resume=" << previous_path << endl;
+    }
+}
+
+// Function to report the first generation at which the two models disagree (generation 0 is the loaded stimulus,
+// so a divergence there is in the shift chain), saving both states
+void report_divergence(const CosimOptions& opts, uint64_t seed, long gen, const PackedGrid& sv_state,
+                       const PackedGrid& vhdl_state, const PackedGrid& reference, const PackedGrid* previous) {
+    int row = 0, col = 0;
+    long cells = first_difference(sv_state, vhdl_state, row, col);
+    cout << "DIVERGED seed " << seed << " generation " << gen << ": " << cells << " cell(s) differ, first at ("
+         << row << ", " << col << ") SV=" << sv_state.get(row, col) << " VHDL=" << vhdl_state.get(row, col) << "\n"
+         << "  SV " << versus_reference(sv_state, reference) << "\n"
+         << "  VHDL " << versus_reference(vhdl_state, reference) << endl;
+    save_cosim_states(opts, seed, gen, sv_state, "sv", vhdl_state, "vhdl", previous);
+}
+
+// Function to report a generation at which both models agree with each other but not with the reference (the same
+// bug on both sides, or one in the reference), saving the models' state and the reference's
+void report_reference_mismatch(const CosimOptions& opts, uint64_t seed, long gen, const PackedGrid& state,
+                               const PackedGrid& reference, const PackedGrid* previous) {
+    int row = 0, col = 0;
+    long cells = first_difference(state, reference, row, col);
+    cout << "MISMATCH seed " << seed << " generation " << gen << ": both models differ from the reference in "
+         << cells << " cell(s), first at (" << row << ", " << col << ") models=" << state.get(row, col)
+         << " reference=" << reference.get(row, col) << endl;
+    save_cosim_states(opts, seed, gen, state, "rtl", reference, "ref", previous);
+}
+
+// Outcome of one co-simulated stimulus
+enum CosimResult { COSIM_PASSED, COSIM_DIVERGED, COSIM_MISMATCHED };
+
+// Function to run one stimulus through both models in lockstep, comparing the two states with each other and with
+// the packed reference after the load and after every generation. A divergence between the models is reported with
+// the side that no longer matches the reference; if they agree but both differ from it, that is a mismatch. Stops
+// at the first failure. The test ends early once the state stops changing.
+CosimResult run_test(Cosim& cosim, const CosimOptions& opts, uint64_t seed, long& generations) {
+    PackedGrid expected = random_grid(opts.rows, opts.columns, seed, opts.density);
+    PackedGrid next(opts.rows, opts.columns);
+    PackedGrid sv_state(opts.rows, opts.columns), vhdl_state(opts.rows, opts.columns);
+
+    cosim.load(expected);
+    cosim.capture(sv_state, vhdl_state);
+    if (sv_state != vhdl_state) {
+        report_divergence(opts, seed, 0, sv_state, vhdl_state, expected, nullptr);
+        return COSIM_DIVERGED;
+    }
+    if (sv_state != expected) {
+        report_reference_mismatch(opts, seed, 0, sv_state, expected, nullptr);
+        return COSIM_MISMATCHED;
+    }
+
+    for (long gen = 1; gen <= opts.generations; ++gen) {
+        cosim.next_time_tick();
+        generations++;
+        calc_packed_state(expected, next, opts.wrap, opts.rule);
+        cosim.capture(sv_state, vhdl_state);
+        if (sv_state != vhdl_state) {
+            report_divergence(opts, seed, gen, sv_state, vhdl_state, next, &expected);
+            return COSIM_DIVERGED;
+        }
+        if (sv_state != next) {
+            report_reference_mismatch(opts, seed, gen, sv_state, next, &expected);
+            return COSIM_MISMATCHED;
+        }
+        if (next == expected) break;             // still life: nothing changes from here on
+        swap(expected, next);
+    }
+    return COSIM_PASSED;
+}
+
+int main(int argc, char** argv) {
+    CosimOptions opts = parse_options(argc, argv);
+    Cosim cosim(argc, argv);
+
+    auto start = chrono::steady_clock::now();
+    long passed = 0, diverged = 0, mismatched = 0, generations = 0;
+    for (long i = 0; i < opts.seeds; ++i) {
+        CosimResult result = run_test(cosim, opts, opts.seed + i, generations);
+        if (result == COSIM_PASSED) passed++;
+        else if (result == COSIM_DIVERGED) diverged++;
+        else mismatched++;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "Co-simulation: " << opts.seeds << " seeds (base seed " << opts.seed << ") on a " << opts.rows << "x"
+         << opts.columns << (opts.wrap ? " torus, " : " grid, ") << passed << " passed, " << diverged << " diverged, "
+         << mismatched << " both differed from the reference" << endl;
+    cout << "  " << generations << " generations in " << seconds << " s: " << generations / seconds
+         << " generations/s for both models" << endl;
+    return diverged || mismatched ? EXIT_FAILURE : EXIT_SUCCESS;
+}
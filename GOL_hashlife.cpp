@@ -0,0 +1,241 @@
+#include <vector>
+#include <algorithm>
+#include "GOL_hashlife.h"
+
+using namespace std;
+
+// Build the quadtree for a game state. The root is the smallest square (at least 32x32) whose central half holds the
+// whole grid, which is what RESULT needs: the center of the root after a jump covers the grid again.
+HashlifeEngine::HashlifeEngine(const PackedGrid& initial_state, const LifeRule& rule)
+    : rows(initial_state.rows), cols(initial_state.cols), rule(rule) {
+    int level = 5;
+    while ((int64_t(1) << (level - 1)) < max(rows, cols)) level++;
+    origin = int64_t(1) << (level - 2);
+    root = build(initial_state, level, 0, 0);
+}
+
+// Function to get the canonical node with the given children (level 4 and up)
+uint32_t HashlifeEngine::make_node(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) {
+    QuadKey key{nw, ne, sw, se};
+    auto it = unique.find(key);
+    if (it != unique.end()) return it->second;
+
+    uint64_t population = nodes[nw].population + nodes[ne].population + nodes[sw].population + nodes[se].population;
+    uint32_t n = nodes.size();
+    nodes.push_back(Node{nw, ne, sw, se, population, nodes[nw].level + 1});
+    unique.emplace(key, n);
+    return n;
+}
+
+// Function to get the canonical 8x8 leaf with the given cells (alive cells must be inside)
+uint32_t HashlifeEngine::make_leaf(uint64_t alive, uint64_t inside) {
+    QuadKey key{uint32_t(alive >> 32), uint32_t(alive), uint32_t(inside >> 32), uint32_t(inside)};
+    auto it = leaves.find(key);
+    if (it != leaves.end()) return it->second;
+
+    uint32_t n = nodes.size();
+    nodes.push_back(Node{key.nw, key.ne, key.sw, key.se, uint64_t(__builtin_popcountll(alive)), LEAF_LEVEL});
+    leaves.emplace(key, n);
+    return n;
+}
+
+uint32_t HashlifeEngine::outside(int level) {
+    if (outside_nodes.empty()) outside_nodes.push_back(make_leaf(0, 0));
+    while (int(outside_nodes.size()) <= level - LEAF_LEVEL) {
+        uint32_t o = outside_nodes.back();
+        outside_nodes.push_back(make_node(o, o, o, o));
+    }
+    return outside_nodes[level - LEAF_LEVEL];
+}
+
+// Function to lay out the four leaves of a level 4 node as 16 rows of 16 cells
+void HashlifeEngine::assemble16(uint32_t n, uint32_t alive[16], uint32_t inside[16]) const {
+    const Node& x = nodes[n];
+    uint32_t quads[4] = {x.nw, x.ne, x.sw, x.se};
+    for (int i = 0; i < 16; ++i) alive[i] = inside[i] = 0;
+    for (int q = 0; q < 4; ++q) {
+        uint64_t a = leaf_alive(quads[q]), m = leaf_inside(quads[q]);
+        int y0 = (q >> 1) * 8, x0 = (q & 1) * 8;
+        for (int y = 0; y < 8; ++y) {
+            alive[y0 + y] |= uint32_t((a >> (8 * y)) & 0xFF) << x0;
+            inside[y0 + y] |= uint32_t((m >> (8 * y)) & 0xFF) << x0;
+        }
+    }
+}
+
+// Function to make a leaf from the central 8x8 of 16 rows of 16 cells
+uint32_t HashlifeEngine::leaf_from16(const uint32_t alive[16], const uint32_t inside[16]) {
+    uint64_t a = 0, m = 0;
+    for (int y = 0; y < 8; ++y) {
+        a |= uint64_t((alive[y + 4] >> 4) & 0xFF) << (8 * y);
+        m |= uint64_t((inside[y + 4] >> 4) & 0xFF) << (8 * y);
+    }
+    return make_leaf(a, m);
+}
+
+// Function to get the central level L-1 square of a level L node (no time step)
+uint32_t HashlifeEngine::center(uint32_t n) {
+    Node x = nodes[n];
+    if (x.level == LEAF_LEVEL + 1) {
+        uint32_t alive[16], inside[16];
+        assemble16(n, alive, inside);
+        return leaf_from16(alive, inside);
+    }
+    return make_node(nodes[x.nw].se, nodes[x.ne].sw, nodes[x.sw].ne, nodes[x.se].nw);
+}
+
+// Function to surround a level L node with outside cells, giving a level L+1 node with it in the center
+uint32_t HashlifeEngine::pad(uint32_t n) {
+    Node x = nodes[n];
+    uint32_t o = outside(x.level - 1);
+    return make_node(make_node(o, o, o, x.nw), make_node(o, o, x.ne, o),
+                     make_node(o, x.sw, o, o), make_node(x.se, o, o, o));
+}
+
+// Function to build the node covering the 2^level square at root coordinates (x0, y0)
+uint32_t HashlifeEngine::build(const PackedGrid& grid, int level, int64_t x0, int64_t y0) {
+    int64_t size = int64_t(1) << level;
+    int64_t gx = x0 - origin, gy = y0 - origin;
+    if (gx >= cols || gy >= rows || gx + size <= 0 || gy + size <= 0) return outside(level);
+    if (level == LEAF_LEVEL) {
+        uint64_t alive = 0, inside = 0;
+        for (int y = 0; y < 8; ++y) {
+            for (int x = 0; x < 8; ++x) {
+                if (gy + y < 0 || gy + y >= rows || gx + x < 0 || gx + x >= cols) continue;
+                inside |= uint64_t(1) << (8 * y + x);
+                if (grid.get(gy + y, gx + x)) alive |= uint64_t(1) << (8 * y + x);
+            }
+        }
+        return make_leaf(alive, inside);
+    }
+    int64_t half = size / 2;
+    uint32_t nw = build(grid, level - 1, x0, y0);
+    uint32_t ne = build(grid, level - 1, x0 + half, y0);
+    uint32_t sw = build(grid, level - 1, x0, y0 + half);
+    uint32_t se = build(grid, level - 1, x0 + half, y0 + half);
+    return make_node(nw, ne, sw, se);
+}
+
+// Function to step a 16x16 node by 2^j generations (j <= 2), giving its central 8x8. Cells past the 16x16 edge are
+// taken as dead, which only disturbs the outer ring of 2^j cells.
+uint32_t HashlifeEngine::base_result(uint32_t n, int j) {
+    uint32_t alive[16], inside[16], next[16];
+    assemble16(n, alive, inside);
+    for (int k = 0; k < (1 << j); ++k) {
+        for (int y = 0; y < 16; ++y) {
+            uint32_t up = y > 0 ? alive[y - 1] : 0, mid = alive[y], dn = y < 15 ? alive[y + 1] : 0;
+            next[y] = life_rule_word(rule, up << 1, up, up >> 1, mid << 1, mid, mid >> 1, dn << 1, dn, dn >> 1);
+            next[y] &= inside[y];        // outside the grid nothing ever comes alive
+        }
+        for (int y = 0; y < 16; ++y) alive[y] = next[y];
+    }
+    return leaf_from16(alive, inside);
+}
+
+// RESULT: the central level L-1 square of level L node n after 2^j generations (j <= L-2). The node is split into
+// nine overlapping level L-1 squares, which are advanced (or just re-centered when j < L-2) into nine level L-2
+// squares; those are regrouped into four level L-1 squares, whose RESULTs form the answer.
+uint32_t HashlifeEngine::result(uint32_t n, int j) {
+    Node x = nodes[n];
+    // An empty region stays empty and the outside stays outside, unless the rule has births on 0 neighbors (B0)
+    if (x.population == 0 && !(rule.birth & 1)) return center(n);
+
+    uint64_t key = uint64_t(n) << 6 | j;
+    auto it = results.find(key);
+    if (it != results.end()) return it->second;
+
+    uint32_t r;
+    if (x.level == LEAF_LEVEL + 1) {
+        r = base_result(n, j);
+    } else {
+        Node a = nodes[x.nw], b = nodes[x.ne], c = nodes[x.sw], d = nodes[x.se];
+        uint32_t sub[9] = {
+            x.nw, make_node(a.ne, b.nw, a.se, b.sw), x.ne,
+            make_node(a.sw, a.se, c.nw, c.ne), make_node(a.se, b.sw, c.ne, d.nw), make_node(b.sw, b.se, d.nw, d.ne),
+            x.sw, make_node(c.ne, d.nw, c.se, d.sw), x.se,
+        };
+        bool full_step = j == x.level - 2;
+        int j2 = full_step ? x.level - 3 : j;
+        for (int k = 0; k < 9; ++k) sub[k] = full_step ? result(sub[k], x.level - 3) : center(sub[k]);
+
+        uint32_t nw = result(make_node(sub[0], sub[1], sub[3], sub[4]), j2);
+        uint32_t ne = result(make_node(sub[1], sub[2], sub[4], sub[5]), j2);
+        uint32_t sw = result(make_node(sub[3], sub[4], sub[6], sub[7]), j2);
+        uint32_t se = result(make_node(sub[4], sub[5], sub[7], sub[8]), j2);
+        r = make_node(nw, ne, sw, se);
+    }
+    results.emplace(key, r);
+    return r;
+}
+
+void HashlifeEngine::step(uint64_t generations) {
+    for (int bit = 0; bit < 64; ++bit) {
+        if (!((generations >> bit) & 1)) continue;
+        // Jumps above 2^60 are split up so the root coordinates stay within 64 bits
+        int j = min(bit, 60);
+        for (uint64_t k = 0; k < (uint64_t(1) << (bit - j)); ++k) {
+            while (nodes[root].level < j + 2) {
+                origin += int64_t(1) << (nodes[root].level - 1);
+                root = pad(root);
+            }
+            // RESULT drops the outer quarter on each side and pad() puts it back, so the origin stays the same
+            root = pad(result(root, j));
+            gen += uint64_t(1) << j;
+        }
+    }
+}
+
+// Function to copy the live cells of node n (a square at root coordinates (x0, y0)) into out
+void HashlifeEngine::extract(PackedGrid& out, uint32_t n, int64_t x0, int64_t y0) const {
+    const Node& x = nodes[n];
+    if (x.population == 0) return;
+    if (x.level == LEAF_LEVEL) {
+        for (uint64_t a = leaf_alive(n); a; a &= a - 1) {
+            int bit = __builtin_ctzll(a);
+            out.set(y0 + bit / 8 - origin, x0 + bit % 8 - origin, true);
+        }
+        return;
+    }
+    int64_t half = int64_t(1) << (x.level - 1);
+    extract(out, x.nw, x0, y0);
+    extract(out, x.ne, x0 + half, y0);
+    extract(out, x.sw, x0, y0 + half);
+    extract(out, x.se, x0 + half, y0 + half);
+}
+
+void HashlifeEngine::get(PackedGrid& out) const {
+    if (out.rows != rows || out.cols != cols) out = PackedGrid(rows, cols);
+    else out.clear();
+    extract(out, root, 0, 0);
+}
+
+// Function to advance a packed game state by any number of generations. Random stimuli are chaotic for their first
+// few hundred generations, which Hashlife handles badly (little repeats) and the packed engine handles well, so short
+// jumps and the first part of long ones use the packed engine and only the settled remainder goes through Hashlife.
+void jump_packed_state(PackedGrid& state, uint64_t generations, bool wrap, const LifeRule& rule) {
+    const uint64_t packed_steps = 1024;
+    PackedGrid next(state.rows, state.cols);
+    if (wrap) {
+        // A finite torus always ends up cycling
+        CycleDetector cycle;
+        cycle.add(state, 0);
+        for (uint64_t k = 1; k <= generations; ++k) {
+            calc_packed_state(state, next, true, rule);
+            swap(state, next);
+            if (generations - k >= 4 * packed_steps && cycle.add(state, k)) {
+                generations = k + (generations - k) % cycle.period;
+            }
+        }
+        return;
+    }
+    uint64_t direct = generations < 4 * packed_steps ? generations : packed_steps;
+    for (uint64_t k = 0; k < direct; ++k) {
+        calc_packed_state(state, next, false, rule);
+        swap(state, next);
+    }
+    if (direct == generations) return;
+
+    HashlifeEngine engine(state, rule);
+    engine.step(generations - direct);
+    engine.get(state);
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+#include "GOL_ref.h"
+
+using namespace std;
+
+// Hashlife reference engine for jumping a game state far ahead (Gosper's algorithm). The universe is a quadtree of
+// hash-consed nodes held in one arena, so identical regions (in space or in time) are stored and computed once, and
+// RESULT (the center of a level L node after 2^j generations, j <= L-2) is memoized per node.
+// GOL.sv has a closed boundary where everything outside the grid stays dead forever, so each leaf carries an inside
+// mask next to its live cells: outside cells never come alive and count as dead neighbors, which keeps the edges
+// exact while the interior of the grid still shares nodes like plain Life.
+// The leaves are 8x8 bitboards (level 3) and the base case steps a 16x16 square up to 4 generations with the same
+// bit-sliced rule as the packed engine, so chaotic regions don't drown in tiny nodes. Any life-like rule works; with
+// births on 0 neighbors (B0) empty regions are no longer free, as they don't stay empty.
+class HashlifeEngine {
+public:
+    explicit HashlifeEngine(const PackedGrid& initial_state, const LifeRule& rule = LifeRule());
+
+    // Advance by any number of generations (one power-of-two jump per set bit)
+    void step(uint64_t generations);
+    uint64_t generation() const { return gen; }
+    uint64_t population() const { return nodes[root].population; }
+
+    // Copy the current game state into out (rows x cols)
+    void get(PackedGrid& out) const;
+
+private:
+    enum { LEAF_LEVEL = 3 };
+
+    // Level 3 leaves keep their 64 cells (bit 8*y + x) in nw:ne (alive) and sw:se (inside)
+    struct Node {
+        uint32_t nw, ne, sw, se;
+        uint64_t population;
+        int level;
+    };
+    struct QuadKey {
+        uint32_t nw, ne, sw, se;
+        bool operator==(const QuadKey& o) const { return nw == o.nw && ne == o.ne && sw == o.sw && se == o.se; }
+    };
+    struct QuadHash {
+        size_t operator()(const QuadKey& k) const {
+            uint64_t h = (uint64_t(k.nw) << 32 | k.ne) * 0x9E3779B97F4A7C15ull;
+            h ^= (uint64_t(k.sw) << 32 | k.se) + (h >> 29);
+            return size_t(h * 0xBF58476D1CE4E5B9ull);
+        }
+    };
+
+    uint32_t make_node(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se);
+    uint32_t make_leaf(uint64_t alive, uint64_t inside);
+    uint64_t leaf_alive(uint32_t n) const { return uint64_t(nodes[n].nw) << 32 | nodes[n].ne; }
+    uint64_t leaf_inside(uint32_t n) const { return uint64_t(nodes[n].sw) << 32 | nodes[n].se; }
+    void assemble16(uint32_t n, uint32_t alive[16], uint32_t inside[16]) const;
+    uint32_t leaf_from16(const uint32_t alive[16], const uint32_t inside[16]);
+    uint32_t outside(int level);
+    uint32_t center(uint32_t n);
+    uint32_t result(uint32_t n, int j);
+    uint32_t base_result(uint32_t n, int j);
+    uint32_t pad(uint32_t n);
+    uint32_t build(const PackedGrid& grid, int level, int64_t x0, int64_t y0);
+    void extract(PackedGrid& out, uint32_t n, int64_t x0, int64_t y0) const;
+
+    int rows, cols;
+    LifeRule rule;
+    vector<Node> nodes;
+    unordered_map<QuadKey, uint32_t, QuadHash> unique;   // level 4 and up
+    unordered_map<QuadKey, uint32_t, QuadHash> leaves;   // level 3
+    unordered_map<uint64_t, uint32_t> results;           // (node << 6 | j) -> RESULT
+    vector<uint32_t> outside_nodes;                      // all-outside node of each level from 3 up
+    uint32_t root;
+    int64_t origin = 0;                                  // root coordinates of grid cell (0, 0), same for x and y
+    uint64_t gen = 0;
+};
+
+// Advance a packed game state by any number of generations. A torus (wrap) has no outside for Hashlife to work
+// with, so it is stepped with the packed engine until its state repeats, and the rest of the jump is taken modulo
+// the period.
+void jump_packed_state(PackedGrid& state, uint64_t generations, bool wrap = false, const LifeRule& rule = LifeRule());
@@ -0,0 +1,73 @@
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+#include "GOL_history.h"
+
+using namespace std;
+
+GameHistory::GameHistory(int rows, int cols, int keyframe_interval)
+    : grid_rows(rows), grid_cols(cols), keyframe_interval(keyframe_interval < 1 ? 1 : keyframe_interval),
+      last(rows, cols), cursor(rows, cols) {}
+
+// Function to append the next generation to the history
+void GameHistory::push(const PackedGrid& state, const GenerationStats& stats) {
+    size_t gen = size();
+    delta_start.push_back(delta_index.size());
+    sample_stats.push_back(stats);
+    if (gen % keyframe_interval == 0) {
+        keyframes.push_back(state.clone());
+    } else {
+        // Store only the words that differ from the previous generation
+        for (int i = 0; i < grid_rows; ++i) {
+            const uint64_t* row = state.row(i);
+            const uint64_t* prev = last.row(i);
+            for (int w = 0; w < state.words_per_row; ++w) {
+                uint64_t diff = row[w] ^ prev[w];
+                if (diff) {
+                    delta_index.push_back(uint32_t(i) * state.words_per_row + w);
+                    delta_bits.push_back(diff);
+                }
+            }
+        }
+    }
+    // Copy without reallocating (both grids have the same layout)
+    last.copy_from(state);
+}
+
+size_t GameHistory::delta_end(size_t gen) const {
+    return gen + 1 < delta_start.size() ? delta_start[gen + 1] : delta_index.size();
+}
+
+// Function to XOR the delta of generation gen into out (which must hold generation gen-1)
+void GameHistory::apply_delta(size_t gen, PackedGrid& out) const {
+    int words = out.words_per_row;
+    for (size_t d = delta_start[gen]; d < delta_end(gen); ++d) {
+        out.row(delta_index[d] / words)[delta_index[d] % words] ^= delta_bits[d];
+    }
+}
+
+void GameHistory::get(size_t gen, PackedGrid& out) const {
+    size_t key = gen - gen % keyframe_interval;
+    if (cursor_gen < long(key) || cursor_gen > long(gen)) {
+        const PackedGrid& keyframe = keyframes[gen / keyframe_interval];
+        cursor.copy_from(keyframe);
+        cursor_gen = key;
+    }
+    for (size_t g = cursor_gen + 1; g <= gen; ++g) apply_delta(g, cursor);
+    cursor_gen = gen;
+    out.copy_from(cursor);
+}
+
+PackedGrid GameHistory::at(size_t gen) const {
+    PackedGrid out(grid_rows, grid_cols);
+    get(gen, out);
+    return out;
+}
+
+// Function to report the memory held by the history (keyframes, deltas and stats)
+size_t GameHistory::memory_bytes() const {
+    size_t bytes = delta_index.capacity() * sizeof(uint32_t) + delta_bits.capacity() * sizeof(uint64_t)
+                 + delta_start.capacity() * sizeof(size_t) + sample_stats.capacity() * sizeof(GenerationStats);
+    for (const PackedGrid& keyframe : keyframes) bytes += keyframe.memory_bytes();
+    return bytes;
+}
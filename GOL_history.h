@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+#include "GOL_ref.h"
+#include "GOL_stats.h"
+
+using namespace std;
+
+// History of the game states of one test, kept in packed form. Every keyframe_interval generations a full copy of
+// the grid is stored; every other generation is stored as the XOR with the generation before it, keeping only the
+// words that changed. Any generation can be rebuilt from the nearest keyframe at or before it. The stats of each
+// generation (computed by the testbench as it captures them) are kept alongside for the GUI's graph.
+class GameHistory {
+public:
+    GameHistory(int rows, int cols, int keyframe_interval = 64);
+
+    void push(const PackedGrid& state, const GenerationStats& stats);
+    size_t size() const { return delta_start.size(); }
+    bool empty() const { return delta_start.empty(); }
+    int rows() const { return grid_rows; }
+    int cols() const { return grid_cols; }
+
+    // Rebuild generation gen into out (must be rows x cols). Stepping forward one generation at a time only applies
+    // one delta; any other access starts from a keyframe.
+    void get(size_t gen, PackedGrid& out) const;
+    PackedGrid at(size_t gen) const;
+    const vector<GenerationStats>& stats() const { return sample_stats; }
+
+    size_t memory_bytes() const;
+
+private:
+    int grid_rows;
+    int grid_cols;
+    int keyframe_interval;
+    vector<PackedGrid> keyframes;     // generation k * keyframe_interval
+    vector<uint32_t> delta_index;     // changed word (row * words_per_row + word) for all deltas, back to back
+    vector<uint64_t> delta_bits;      // XOR of that word with the previous generation
+    vector<size_t> delta_start;       // first delta word of each generation (a keyframe generation has none)
+    vector<GenerationStats> sample_stats;
+    PackedGrid last;                  // most recent state, to compute the next delta
+
+    // Last generation handed out by get(), so stepping forward is cheap
+    mutable PackedGrid cursor;
+    mutable long cursor_gen = -1;
+
+    size_t delta_end(size_t gen) const;
+    void apply_delta(size_t gen, PackedGrid& out) const;
+};
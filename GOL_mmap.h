@@ -0,0 +1,94 @@
+#pragma once
+#include <string>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+// Read-only memory mapping of a whole file (empty files map to an empty range). The mapping is page aligned.
+struct MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const string& path, string& error) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error = strerror(errno);
+            return false;
+        }
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0;
+        if (ok && st.st_size > 0) {
+            void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ok = p != MAP_FAILED;
+            if (ok) {
+                data = static_cast<const char*>(p);
+                size = st.st_size;
+            }
+        }
+        if (!ok) error = strerror(errno);
+        ::close(fd);                 // the mapping stays valid after the descriptor is closed
+        return ok;
+    }
+
+    void close() {
+        if (data) munmap(const_cast<char*>(data), size);
+        data = nullptr;
+        size = 0;
+    }
+};
+
+// Writable shared mapping of a file created (or truncated) at a given size. The file starts out all zeros and writes
+// to data go straight to the file; close() flushes them.
+struct WritableMappedFile {
+    char* data = nullptr;
+    size_t size = 0;
+
+    WritableMappedFile() = default;
+    WritableMappedFile(const WritableMappedFile&) = delete;
+    WritableMappedFile& operator=(const WritableMappedFile&) = delete;
+    ~WritableMappedFile() { string error; close(error); }
+
+    bool create(const string& path, size_t file_size, string& error) {
+        if (!close(error)) return false;
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            error = strerror(errno);
+            return false;
+        }
+        bool ok = ftruncate(fd, file_size) == 0;
+        if (ok && file_size > 0) {
+            void* p = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            ok = p != MAP_FAILED;
+            if (ok) {
+                data = static_cast<char*>(p);
+                size = file_size;
+            }
+        }
+        if (!ok) error = strerror(errno);
+        ::close(fd);
+        return ok;
+    }
+
+    bool close(string& error) {
+        bool ok = true;
+        if (data) {
+            ok = msync(data, size, MS_SYNC) == 0;
+            if (!ok) error = strerror(errno);
+            munmap(data, size);
+        }
+        data = nullptr;
+        size = 0;
+        return ok;
+    }
+};
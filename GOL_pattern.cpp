@@ -0,0 +1,213 @@
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "GOL_pattern.h"
+#include "GOL_mmap.h"
+
+using namespace std;
+
+static bool has_extension(const string& path, const char* ext) {
+    size_t n = strlen(ext);
+    return path.size() >= n && !strcasecmp(path.c_str() + path.size() - n, ext);
+}
+
+// Function to set n cells starting at (row, col), clipped to the grid, a whole word at a time
+static void set_run(PackedGrid& grid, long row, long col, long n) {
+    if (row < 0 || row >= grid.rows || n <= 0) return;
+    long c0 = max(col, 0L), c1 = min(col + n, long(grid.cols));
+    uint64_t* r = grid.row(row);
+    for (long w = c0 >> 6; c0 < c1; ++w) {
+        long lo = c0 - 64 * w, hi = min(c1 - 64 * w, 64L);
+        uint64_t mask = (hi == 64 ? ~uint64_t(0) : (uint64_t(1) << hi) - 1) & ~((uint64_t(1) << lo) - 1);
+        r[w] |= mask;
+        c0 = 64 * (w + 1);
+    }
+}
+
+static const char* skip_line(const char* p, const char* end) {
+    while (p < end && *p != '\n') ++p;
+    return p < end ? p + 1 : end;
+}
+
+// Function to parse one "key = value" number out of an RLE header line
+static bool header_value(const char* p, const char* line_end, char key, long& value) {
+    for (; p < line_end; ++p) {
+        if (*p != key) continue;
+        const char* q = p + 1;
+        while (q < line_end && (*q == ' ' || *q == '\t')) ++q;
+        if (q >= line_end || *q != '=') continue;
+        value = strtol(q + 1, nullptr, 10);
+        return true;
+    }
+    return false;
+}
+
+// RLE: optional '#' comment lines, a header "x = W, y = H[, rule = B3/S23]", then runs: <count>b (dead), <count>o
+// (alive, any other letter too), <count>$ (end of row), ! (end of pattern). A pattern without a rule is taken to be
+// for Life, like everywhere else.
+static bool parse_rle(const char* p, const char* end, PackedGrid& grid, const PatternPlacement& placement,
+                      const LifeRule& rule, string& error) {
+    while (p < end && (*p == '#' || *p == '\n' || *p == '\r')) p = skip_line(p, end);
+
+    long width = 0, height = 0;
+    bool have_header = p < end && *p == 'x';
+    if (have_header) {
+        const char* line_end = skip_line(p, end);
+        header_value(p, line_end, 'x', width);
+        header_value(p, line_end, 'y', height);
+        const char* rule_key = static_cast<const char*>(memmem(p, line_end - p, "rule", 4));
+        LifeRule pattern_rule;
+        if (rule_key) {
+            rule_key = static_cast<const char*>(memchr(rule_key, '=', line_end - rule_key));
+            string r;
+            const char* q = rule_key ? rule_key + 1 : line_end;
+            for (; q < line_end && *q != ',' && *q != '\r' && *q != '\n'; ++q) {
+                if (*q != ' ' && *q != '\t') r += *q;
+            }
+            if (!parse_life_rule(r, pattern_rule)) {
+                error = "unsupported rule " + r;
+                return false;
+            }
+        }
+        if (pattern_rule != rule) {
+            error = "pattern is for rule " + pattern_rule.name() + ", not " + rule.name();
+            return false;
+        }
+        p = line_end;
+    }
+
+    // Without a header the size is unknown, so the pattern can only go at the given offset
+    long row = placement.row, col0 = placement.col;
+    if (placement.center && have_header) {
+        row = (grid.rows - height) / 2;
+        col0 = (grid.cols - width) / 2;
+    }
+
+    long col = col0, count = 0;
+    for (; p < end; ++p) {
+        char c = *p;
+        if (c >= '0' && c <= '9') {
+            count = min(count * 10 + (c - '0'), 1L << 30);
+            continue;
+        }
+        long n = count ? count : 1;
+        count = 0;
+        if (c == 'b' || c == '.') col += n;
+        else if (c == '$') {
+            row += n;
+            col = col0;
+        }
+        else if (c == '!') return true;
+        else if (c == '#') p = skip_line(p, end) - 1;
+        else if (isalpha((unsigned char)c)) {
+            set_run(grid, row, col, n);
+            col += n;
+        }
+        else if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+            error = string("unexpected character '") + c + "' in RLE data";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Plaintext: '!' comment lines, then one line per row with '.' for dead and 'O' (or '*') for alive cells
+static bool parse_cells(const char* begin, const char* end, PackedGrid& grid, const PatternPlacement& placement,
+                        string& error) {
+    long row = placement.row, col0 = placement.col;
+    if (placement.center) {
+        // The size isn't stored in the file, so measure it first (cheap next to the parse itself)
+        long width = 0, height = 0;
+        for (const char* p = begin; p < end; ) {
+            const char* line_end = skip_line(p, end);
+            if (*p != '!') {
+                long n = 0;
+                for (const char* q = p; q < line_end; ++q) n += *q == '.' || *q == 'O' || *q == '*';
+                width = max(width, n);
+                height++;
+            }
+            p = line_end;
+        }
+        row = (grid.rows - height) / 2;
+        col0 = (grid.cols - width) / 2;
+    }
+
+    for (const char* p = begin; p < end; ) {
+        const char* line_end = skip_line(p, end);
+        if (*p == '!') {
+            p = line_end;
+            continue;
+        }
+        long col = col0, run_start = 0, run = 0;
+        for (; p < line_end; ++p) {
+            char c = *p;
+            if (c == 'O' || c == '*') {
+                if (!run) run_start = col;
+                run++;
+                col++;
+                continue;
+            }
+            set_run(grid, row, run_start, run);
+            run = 0;
+            if (c == '.') col++;
+            else if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+                error = string("unexpected character '") + c + "' in .cells data";
+                return false;
+            }
+        }
+        set_run(grid, row, run_start, run);
+        row++;
+    }
+    return true;
+}
+
+bool load_pattern(const string& path, PackedGrid& grid, const PatternPlacement& placement, const LifeRule& rule,
+                  string& error) {
+    MappedFile file;
+    if (!file.open(path, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    const char* begin = file.data;
+    const char* end = begin + file.size;
+
+    // Unknown extensions: RLE files start with '#' comments or the "x = " header, plaintext with '!' or a row
+    bool rle = has_extension(path, ".rle");
+    if (!rle && !has_extension(path, ".cells")) {
+        const char* p = begin;
+        while (p < end && (*p == ' ' || *p == '\r' || *p == '\n')) ++p;
+        rle = p < end && (*p == '#' || *p == 'x');
+    }
+    bool ok = rle ? parse_rle(begin, end, grid, placement, rule, error)
+                  : parse_cells(begin, end, grid, placement, error);
+    if (!ok) error = path + ": " + error;
+    return ok;
+}
+
+bool add_pattern_paths(const string& path, vector<string>& paths, string& error) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+        paths.push_back(path);       // a missing file is reported when it is loaded
+        return true;
+    }
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+    vector<string> found;
+    while (dirent* entry = readdir(dir)) {
+        string name = entry->d_name;
+        if (has_extension(name, ".rle") || has_extension(name, ".cells")) found.push_back(path + "/" + name);
+    }
+    closedir(dir);
+    sort(found.begin(), found.end());
+    paths.insert(paths.end(), found.begin(), found.end());
+    return true;
+}
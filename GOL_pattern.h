@@ -0,0 +1,25 @@
+#pragma once
+#include <vector>
+#include <string>
+#include "GOL_ref.h"
+
+using namespace std;
+
+// Where a pattern goes in the grid: centered, or with its top-left cell at (row, col). Either way the cells that
+// fall outside the grid are clipped.
+struct PatternPlacement {
+    bool center = true;
+    int row = 0;
+    int col = 0;
+};
+
+// Function to load an RLE (.rle) or plaintext (.cells) pattern file into grid, which keeps its size. The file is
+// memory-mapped and parsed in a single pass straight into the packed rows (runs of live cells are set a word at a
+// time). The format comes from the extension, or from the content for other names. Returns false with a message in
+// error if the file can't be read or isn't a pattern for rule (RLE files name theirs, plaintext has none).
+bool load_pattern(const string& path, PackedGrid& grid, const PatternPlacement& placement, const LifeRule& rule,
+                  string& error);
+
+// Function to add a pattern path to the list: a directory adds all the .rle and .cells files in it (sorted by name),
+// anything else is added as it is. Returns false with a message in error if a directory can't be read.
+bool add_pattern_paths(const string& path, vector<string>& paths, string& error);
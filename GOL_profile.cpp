@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <iomanip>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include "GOL_profile.h"
+#include "GOL_ref.h"
+
+using namespace std;
+
+static const char* const PHASE_NAMES[PHASE_COUNT] = {
+    "stimulus", "apply", "tick", "capture", "convert", "history", "stats", "reference", "trace"
+};
+
+#if GOL_PROFILE
+thread_local ScopedTimer* ScopedTimer::current = nullptr;
+
+static mutex registry_mutex;
+static vector<unique_ptr<ProfileCounters>> registry;
+
+ProfileCounters& profile_counters() {
+    thread_local ProfileCounters* counters = [] {
+        lock_guard<mutex> lock(registry_mutex);
+        registry.emplace_back(new ProfileCounters);
+        return registry.back().get();
+    }();
+    return *counters;
+}
+
+// Function to sum the counters of every thread (call once the threads are done)
+static ProfileCounters profile_total(size_t& threads) {
+    lock_guard<mutex> lock(registry_mutex);
+    ProfileCounters total;
+    for (const auto& counters : registry) {
+        for (int p = 0; p < PHASE_COUNT; ++p) {
+            total.ns[p] += counters->ns[p];
+            total.calls[p] += counters->calls[p];
+        }
+        total.evals += counters->evals;
+        total.generations += counters->generations;
+    }
+    threads = registry.size();
+    return total;
+}
+
+void profile_report(ostream& out, int rows, int cols, double wall_seconds) {
+    size_t threads = 0;
+    ProfileCounters total = profile_total(threads);
+    uint64_t phase_ns = 0;
+    for (int p = 0; p < PHASE_COUNT; ++p) phase_ns += total.ns[p];
+
+    streamsize precision = out.precision();
+    out << "Profile: " << wall_seconds << " s wall, " << threads << " thread(s) counted, reference engine "
+        << packed_engine_name() << endl;
+    out << "  phase          calls      total s    share    mean us" << endl;
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        double seconds = total.ns[p] * 1e-9;
+        out << "  " << left << setw(10) << PHASE_NAMES[p] << right << setw(10) << total.calls[p] << fixed
+            << setprecision(4) << setw(13) << seconds << setprecision(1) << setw(8)
+            << (phase_ns ? 100.0 * total.ns[p] / phase_ns : 0.0) << "%" << setprecision(2) << setw(11)
+            << (total.calls[p] ? total.ns[p] * 1e-3 / total.calls[p] : 0.0) << defaultfloat << setprecision(precision)
+            << endl;
+    }
+    double cells = double(total.generations) * rows * cols;
+    out << "  " << total.evals << " evals (" << total.evals / wall_seconds << " evals/s), " << total.generations
+        << " generations, " << cells / wall_seconds << " cells/s" << endl;
+}
+
+bool profile_write_json(const string& path, int rows, int cols, double wall_seconds, string& error) {
+    size_t threads = 0;
+    ProfileCounters total = profile_total(threads);
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+    fprintf(f, "{\n  \"rows\": %d,\n  \"cols\": %d,\n  \"wall_seconds\": %.6f,\n  \"threads\": %zu,\n", rows, cols,
+            wall_seconds, threads);
+    fprintf(f, "  \"reference_engine\": \"%s\",\n", packed_engine_name());
+    fprintf(f, "  \"evals\": %llu,\n  \"generations\": %llu,\n  \"cells_per_second\": %.1f,\n  \"phases\": {\n",
+            (unsigned long long)total.evals, (unsigned long long)total.generations,
+            double(total.generations) * rows * cols / wall_seconds);
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        fprintf(f, "    \"%s\": {\"calls\": %llu, \"seconds\": %.6f}%s\n", PHASE_NAMES[p],
+                (unsigned long long)total.calls[p], total.ns[p] * 1e-9, p + 1 < PHASE_COUNT ? "," : "");
+    }
+    fprintf(f, "  }\n}\n");
+    if (fclose(f) != 0) {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+    return true;
+}
+#else
+void profile_report(ostream& out, int, int, double) {
+    out << "Profile: not built in (rebuild with make PROFILE=1)" << endl;
+}
+
+bool profile_write_json(const string& path, int, int, double, string& error) {
+    error = path + ": profile not built in (rebuild with make PROFILE=1)";
+    return false;
+}
+#endif
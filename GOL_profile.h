@@ -0,0 +1,81 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+// Testbench phase timers, built with make PROFILE=1 (GOL_PROFILE). Without it the macros expand to nothing, so the
+// instrumentation costs nothing in a normal build.
+#ifndef GOL_PROFILE
+#define GOL_PROFILE 0
+#endif
+
+// Phases of a testbench run. Times are exclusive: a timer nested in another (e.g. a trace dump inside a tick) is
+// taken out of the outer phase, so the phases add up to the time spent in any of them.
+enum ProfilePhase {
+    PHASE_STIMULUS,                  // random, pattern or snapshot stimulus generation
+    PHASE_APPLY,                     // shifting the stimulus into the DUT
+    PHASE_TICK,                      // NextTimeTick pulses (and other clocks outside loading and readback)
+    PHASE_CAPTURE,                   // reading the DUT state back (shift or GOL.status)
+    PHASE_CONVERT,                   // PackedGrid copies (clone) outside the other phases
+    PHASE_HISTORY,                   // GUI history pushes (--replay)
+    PHASE_STATS,                     // population/births/deaths/bounding box of each generation (--stats, GUI)
+    PHASE_REFERENCE,                 // reference model steps and comparisons (checker threads)
+    PHASE_TRACE,                     // waveform dumps
+    PHASE_COUNT
+};
+
+// Counters of one thread (each thread counts into its own, they are summed when reported)
+struct ProfileCounters {
+    uint64_t ns[PHASE_COUNT] = {};
+    uint64_t calls[PHASE_COUNT] = {};
+    uint64_t evals = 0;              // Verilated model evals
+    uint64_t generations = 0;        // generations simulated by the DUT
+};
+
+#if GOL_PROFILE
+// Function to get the calling thread's counters (registered on first use, kept until exit)
+ProfileCounters& profile_counters();
+
+// Adds the time from construction to destruction to a phase, less the time of timers nested inside it
+class ScopedTimer {
+public:
+    explicit ScopedTimer(ProfilePhase phase) : phase(phase), parent(current), start(chrono::steady_clock::now()) {
+        current = this;
+    }
+    ~ScopedTimer() {
+        uint64_t ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+        ProfileCounters& counters = profile_counters();
+        counters.ns[phase] += ns - nested_ns;
+        counters.calls[phase]++;
+        if (parent) parent->nested_ns += ns;
+        current = parent;
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    static thread_local ScopedTimer* current;
+    ProfilePhase phase;
+    ScopedTimer* parent;
+    chrono::steady_clock::time_point start;
+    uint64_t nested_ns = 0;
+};
+
+#define GOL_PROFILE_CONCAT2(a, b) a##b
+#define GOL_PROFILE_CONCAT(a, b) GOL_PROFILE_CONCAT2(a, b)
+#define GOL_PROFILE_SCOPE(phase) ScopedTimer GOL_PROFILE_CONCAT(profile_timer_, __LINE__)(phase)
+#define GOL_PROFILE_COUNT(field, n) (profile_counters().field += (n))
+#else
+#define GOL_PROFILE_SCOPE(phase)
+#define GOL_PROFILE_COUNT(field, n)
+#endif
+
+// Function to print the per-phase breakdown, eval count and cells/s of the whole run (all threads) for a grid of
+// rows x cols cells, over wall_seconds of wall time. Prints a note instead if the profiler isn't built in.
+void profile_report(ostream& out, int rows, int cols, double wall_seconds);
+
+// Function to write the same report as JSON. Returns false with a message in error if the file can't be written.
+bool profile_write_json(const string& path, int rows, int cols, double wall_seconds, string& error);
@@ -0,0 +1,34 @@
+#include <math.h>
+#include "GOL_random.h"
+
+using namespace std;
+
+Xoshiro256::Xoshiro256(uint64_t seed) {
+    // splitmix64, which never gives an all-zero state
+    for (uint64_t& word : s) {
+        seed += 0x9E3779B97F4A7C15ull;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        word = z ^ (z >> 31);
+    }
+}
+
+CellSampler::CellSampler(double density) {
+    level = int(lround(min(1.0, max(0.0, density)) * 256));
+    first_bit = level ? __builtin_ctz(level) : 8;
+}
+
+PackedGrid random_grid(int rows, int cols, uint64_t seed, double density) {
+    PackedGrid grid(rows, cols);
+    Xoshiro256 rng(seed);
+    CellSampler sampler(density);
+    if (sampler.all_dead()) return grid;
+    uint64_t tail = (cols & 63) ? (uint64_t(1) << (cols & 63)) - 1 : ~uint64_t(0);
+    for (int i = 0; i < rows; ++i) {
+        uint64_t* row = grid.row(i);
+        for (int w = 0; w < grid.words_per_row; ++w) row[w] = sampler.all_alive() ? ~uint64_t(0) : sampler.next(rng);
+        row[grid.words_per_row - 1] &= tail;
+    }
+    return grid;
+}
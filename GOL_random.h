@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+#include "GOL_ref.h"
+
+using namespace std;
+
+// xoshiro256** random number generator (Blackman and Vigna). The 256-bit state is expanded from a single 64-bit seed
+// with splitmix64, so a seed fully determines the stream on every platform. This is also how the stream is split
+// between tests: test i gets its own generator seeded with seed + i (splitmix64 spreads neighboring seeds over the
+// whole state), so every test can be re-run on its own with its seed, whichever worker thread ran it.
+class Xoshiro256 {
+public:
+    explicit Xoshiro256(uint64_t seed);
+
+    uint64_t next() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+    uint64_t s[4];
+};
+
+// Draws 64 cells at a time, each alive with probability density (in steps of 1/256). A bit that is alive with
+// probability p/2^k is the AND (bit of p is 0) or OR (bit is 1) of a fresh random word with the word for the lower
+// bits, so density 0.5 takes one draw per word, 0.25 two, and any density at most 8.
+class CellSampler {
+public:
+    explicit CellSampler(double density);
+    uint64_t next(Xoshiro256& rng) const {
+        uint64_t word = rng.next();
+        for (int b = first_bit + 1; b < 8; ++b) word = ((level >> b) & 1) ? word | rng.next() : word & rng.next();
+        return word;
+    }
+    bool all_dead() const { return level == 0; }
+    bool all_alive() const { return level >= 256; }
+
+private:
+    int level;                       // density * 256
+    int first_bit;                   // lowest set bit of level
+};
+
+// Function to generate a random rows x cols game state with the given live density, fully determined by seed
+PackedGrid random_grid(int rows, int cols, uint64_t seed, double density = 0.5);
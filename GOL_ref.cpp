@@ -0,0 +1,402 @@
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include "GOL_ref.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace std;
+
+// Allocate an all-dead n x m packed grid. The stride is rounded up to a whole cache line and always leaves at least
+// one zero word after the last real word, so the widest vector loop can read one word past the row.
+PackedGrid::PackedGrid(int n, int m) : rows(n), cols(m) {
+    words_per_row = (m + 63) / 64;
+    stride = (words_per_row + 1 + 7) & ~7;
+    bits.assign((rows + 2) * stride + 16, 0);
+}
+
+PackedGrid PackedGrid::clone() const {
+    PackedGrid copy;
+    copy.copy_from(*this);
+    return copy;
+}
+
+void PackedGrid::copy_from(const PackedGrid& other) {
+    rows = other.rows;
+    cols = other.cols;
+    words_per_row = other.words_per_row;
+    stride = other.stride;
+    bits.assign(other.bits.begin(), other.bits.end());
+    cached_hash = other.cached_hash;
+    cached_population = other.cached_population;
+    hash_valid = other.hash_valid;
+    population_valid = other.population_valid;
+}
+
+void PackedGrid::clear() {
+    fill(bits.begin(), bits.end(), 0);
+    changed();
+}
+
+uint64_t PackedGrid::hash() const {
+    if (!hash_valid) {
+        cached_hash = hash_rows(row(0), rows, cols, stride);
+        hash_valid = true;
+    }
+    return cached_hash;
+}
+
+long PackedGrid::population() const {
+    if (!population_valid) {
+        cached_population = 0;
+        for (int i = 0; i < rows; ++i) cached_population += row_view(i).population();
+        population_valid = true;
+    }
+    return cached_population;
+}
+
+bool PackedGrid::operator==(const PackedGrid& other) const {
+    if (rows != other.rows || cols != other.cols) return false;
+    if (hash_valid && other.hash_valid && cached_hash != other.cached_hash) return false;
+    // Padding and guard words are always zero, so the whole buffer can be compared word by word
+    return bits == other.bits;
+}
+
+// Clear the bits past the last real column and any padding words written by a vector loop
+static inline void mask_row_tail(const PackedGrid& grid, uint64_t* row, int vec_words) {
+    if (grid.cols & 63) row[grid.words_per_row - 1] &= (uint64_t(1) << (grid.cols & 63)) - 1;
+    for (int w = grid.words_per_row; w < vec_words; ++w) row[w] = 0;
+}
+
+string LifeRule::name() const {
+    string text = "B";
+    for (int n = 0; n <= 8; ++n) if (birth >> n & 1) text += char('0' + n);
+    text += "/S";
+    for (int n = 0; n <= 8; ++n) if (survive >> n & 1) text += char('0' + n);
+    return text;
+}
+
+// Function to read a run of neighbor counts (digits 0 to 8) into a mask
+static const char* parse_counts(const char* p, uint16_t& mask) {
+    mask = 0;
+    for (; *p >= '0' && *p <= '8'; ++p) mask |= 1 << (*p - '0');
+    return p;
+}
+
+bool parse_life_rule(const string& text, LifeRule& rule) {
+    const char* p = text.c_str();
+    LifeRule parsed;
+    if (isdigit((unsigned char)*p) || *p == '/') {
+        // S/B: survive counts first, no letters
+        p = parse_counts(p, parsed.survive);
+        if (*p++ != '/') return false;
+        p = parse_counts(p, parsed.birth);
+    } else {
+        bool seen_birth = false, seen_survive = false;
+        while (*p) {
+            char c = tolower((unsigned char)*p++);
+            if (c == 'b' && !seen_birth) {
+                p = parse_counts(p, parsed.birth);
+                seen_birth = true;
+            } else if (c == 's' && !seen_survive) {
+                p = parse_counts(p, parsed.survive);
+                seen_survive = true;
+            } else {
+                return false;
+            }
+            if (*p == '/' && p[1]) ++p;
+        }
+        if (!seen_birth || !seen_survive) return false;
+    }
+    if (*p) return false;
+    rule = parsed;
+    return true;
+}
+
+// Kernels are templates on the rule masks, so each rule gets its own copy of the loop with the rule folded into it.
+// The one instantiated with RUNTIME_RULE reads the masks from its rule argument instead, for any other rule.
+enum : uint16_t { RUNTIME_RULE = 0xFFFF };
+
+#define GOL_KERNEL_MASKS(rule)                                                                                    \
+    const uint16_t birth = Birth == RUNTIME_RULE ? rule.birth : Birth;                                            \
+    const uint16_t survive = Survive == RUNTIME_RULE ? rule.survive : Survive
+
+// The rule of a kernel: Conway's rule takes the shorter GOL_LIFE_RULE, any other GOL_LIFE_LIKE_RULE
+#define GOL_KERNEL_RULE(AND, OR, XOR, ANDNOT, ONES, ul, u, ur, l, c, r, dl, d, dr, out) do {                      \
+        if constexpr (Birth == (1 << 3) && Survive == (1 << 2 | 1 << 3))                                          \
+            GOL_LIFE_RULE(AND, OR, XOR, ANDNOT, ul, u, ur, l, c, r, dl, d, dr, out);                              \
+        else                                                                                                      \
+            GOL_LIFE_LIKE_RULE(birth, survive, AND, OR, XOR, ANDNOT, ONES, ul, u, ur, l, c, r, dl, d, dr, out);   \
+    } while (0)
+
+// Scalar fallback: one 64-bit word (64 cells) per iteration
+template <uint16_t Birth, uint16_t Survive>
+static void calc_packed_state_scalar(const PackedGrid& current_state, PackedGrid& next_state, const LifeRule& rule) {
+    GOL_KERNEL_MASKS(rule);
+    for (int i = 0; i < current_state.rows; ++i) {
+        const uint64_t* up = current_state.row(i - 1);
+        const uint64_t* mid = current_state.row(i);
+        const uint64_t* dn = current_state.row(i + 1);
+        uint64_t* out = next_state.row(i);
+        for (int w = 0; w < current_state.words_per_row; ++w) {
+            // Shift each row by one column in both directions, carrying bits across word boundaries
+            uint64_t ul = (up[w] << 1) | (up[w - 1] >> 63), ur = (up[w] >> 1) | (up[w + 1] << 63);
+            uint64_t l = (mid[w] << 1) | (mid[w - 1] >> 63), r = (mid[w] >> 1) | (mid[w + 1] << 63);
+            uint64_t dl = (dn[w] << 1) | (dn[w - 1] >> 63), dr = (dn[w] >> 1) | (dn[w + 1] << 63);
+            GOL_KERNEL_RULE(GOL_SCALAR_AND, GOL_SCALAR_OR, GOL_SCALAR_XOR, GOL_SCALAR_ANDNOT, ~uint64_t(0),
+                            ul, up[w], ur, l, mid[w], r, dl, dn[w], dr, out[w]);
+        }
+        mask_row_tail(current_state, out, current_state.words_per_row);
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// AVX2 path: four words (256 cells) per iteration. Compiled with a target attribute and selected at runtime so the
+// rest of the testbench does not need to be built with -mavx2.
+#define GOL_AVX2_SHL1(p) _mm256_or_si256(_mm256_slli_epi64(_mm256_loadu_si256((const __m256i*)(p)), 1), \
+                                         _mm256_srli_epi64(_mm256_loadu_si256((const __m256i*)((p) - 1)), 63))
+#define GOL_AVX2_SHR1(p) _mm256_or_si256(_mm256_srli_epi64(_mm256_loadu_si256((const __m256i*)(p)), 1), \
+                                         _mm256_slli_epi64(_mm256_loadu_si256((const __m256i*)((p) + 1)), 63))
+
+template <uint16_t Birth, uint16_t Survive>
+__attribute__((target("avx2")))
+static void calc_packed_state_avx2(const PackedGrid& current_state, PackedGrid& next_state, const LifeRule& rule) {
+    GOL_KERNEL_MASKS(rule);
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    int vec_words = (current_state.words_per_row + 3) & ~3;
+    for (int i = 0; i < current_state.rows; ++i) {
+        const uint64_t* up = current_state.row(i - 1);
+        const uint64_t* mid = current_state.row(i);
+        const uint64_t* dn = current_state.row(i + 1);
+        uint64_t* out = next_state.row(i);
+        for (int w = 0; w < vec_words; w += 4) {
+            __m256i u = _mm256_loadu_si256((const __m256i*)(up + w));
+            __m256i c = _mm256_loadu_si256((const __m256i*)(mid + w));
+            __m256i d = _mm256_loadu_si256((const __m256i*)(dn + w));
+            __m256i next;
+            GOL_KERNEL_RULE(_mm256_and_si256, _mm256_or_si256, _mm256_xor_si256, _mm256_andnot_si256, ones,
+                            GOL_AVX2_SHL1(up + w), u, GOL_AVX2_SHR1(up + w),
+                            GOL_AVX2_SHL1(mid + w), c, GOL_AVX2_SHR1(mid + w),
+                            GOL_AVX2_SHL1(dn + w), d, GOL_AVX2_SHR1(dn + w), next);
+            _mm256_storeu_si256((__m256i*)(out + w), next);
+        }
+        mask_row_tail(current_state, out, vec_words);
+    }
+}
+#endif
+
+#if defined(__ARM_NEON)
+// NEON path: two words (128 cells) per iteration
+#define GOL_NEON_SHL1(p) vorrq_u64(vshlq_n_u64(vld1q_u64(p), 1), vshrq_n_u64(vld1q_u64((p) - 1), 63))
+#define GOL_NEON_SHR1(p) vorrq_u64(vshrq_n_u64(vld1q_u64(p), 1), vshlq_n_u64(vld1q_u64((p) + 1), 63))
+#define GOL_NEON_ANDNOT(a, b) vbicq_u64(b, a)
+
+template <uint16_t Birth, uint16_t Survive>
+static void calc_packed_state_neon(const PackedGrid& current_state, PackedGrid& next_state, const LifeRule& rule) {
+    GOL_KERNEL_MASKS(rule);
+    const uint64x2_t ones = vdupq_n_u64(~uint64_t(0));
+    int vec_words = (current_state.words_per_row + 1) & ~1;
+    for (int i = 0; i < current_state.rows; ++i) {
+        const uint64_t* up = current_state.row(i - 1);
+        const uint64_t* mid = current_state.row(i);
+        const uint64_t* dn = current_state.row(i + 1);
+        uint64_t* out = next_state.row(i);
+        for (int w = 0; w < vec_words; w += 2) {
+            uint64x2_t next;
+            GOL_KERNEL_RULE(vandq_u64, vorrq_u64, veorq_u64, GOL_NEON_ANDNOT, ones,
+                            GOL_NEON_SHL1(up + w), vld1q_u64(up + w), GOL_NEON_SHR1(up + w),
+                            GOL_NEON_SHL1(mid + w), vld1q_u64(mid + w), GOL_NEON_SHR1(mid + w),
+                            GOL_NEON_SHL1(dn + w), vld1q_u64(dn + w), GOL_NEON_SHR1(dn + w), next);
+            vst1q_u64(out + w, next);
+        }
+        mask_row_tail(current_state, out, vec_words);
+    }
+}
+#endif
+
+typedef void (*packed_engine_fn)(const PackedGrid&, PackedGrid&, const LifeRule&);
+
+// Pick the widest engine for one rule supported by the host the first time the reference model runs
+template <uint16_t Birth, uint16_t Survive>
+static packed_engine_fn select_packed_engine(const char** name) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (__builtin_cpu_supports("avx2")) {
+        *name = "avx2";
+        return calc_packed_state_avx2<Birth, Survive>;
+    }
+#elif defined(__ARM_NEON)
+    *name = "neon";
+    return calc_packed_state_neon<Birth, Survive>;
+#endif
+    *name = "scalar";
+    return calc_packed_state_scalar<Birth, Survive>;
+}
+
+static const char* packed_engine = nullptr;
+
+struct RuleEngine {
+    uint16_t birth;
+    uint16_t survive;
+    packed_engine_fn engine;
+};
+#define GOL_RULE_ENGINE(birth, survive) {birth, survive, select_packed_engine<birth, survive>(&packed_engine)}
+
+// Rules with kernels of their own (Conway's first, as it is looked up on every step)
+static const RuleEngine rule_engines[] = {
+    GOL_RULE_ENGINE(0x008, 0x00C),   // B3/S23, Conway's Life
+    GOL_RULE_ENGINE(0x048, 0x00C),   // B36/S23, HighLife
+    GOL_RULE_ENGINE(0x1C8, 0x1D8),   // B3678/S34678, Day & Night
+    GOL_RULE_ENGINE(0x004, 0x000),   // B2/S, Seeds
+    GOL_RULE_ENGINE(0x008, 0x1FF),   // B3/S012345678, Life without Death
+    GOL_RULE_ENGINE(0x148, 0x034),   // B368/S245, Morley
+    GOL_RULE_ENGINE(0x048, 0x026),   // B36/S125, 2x2
+};
+static const packed_engine_fn runtime_rule_engine = select_packed_engine<RUNTIME_RULE, RUNTIME_RULE>(&packed_engine);
+
+// Function to find the kernel compiled for a rule, or the one that reads the masks at runtime
+static packed_engine_fn rule_engine(const LifeRule& rule) {
+    for (const RuleEngine& e : rule_engines) {
+        if (e.birth == rule.birth && e.survive == rule.survive) return e.engine;
+    }
+    return runtime_rule_engine;
+}
+
+const char* packed_engine_name() {
+    return packed_engine;
+}
+
+bool life_rule_specialized(const LifeRule& rule) {
+    return rule_engine(rule) != runtime_rule_engine;
+}
+
+// Function to calculate cell (i, j) of the next generation with the grid's edges wrapped around (a torus)
+static inline bool wrapped_next_cell(const PackedGrid& g, int i, int j, const LifeRule& rule) {
+    int up = i > 0 ? i - 1 : g.rows - 1, dn = i + 1 < g.rows ? i + 1 : 0;
+    int left = j > 0 ? j - 1 : g.cols - 1, right = j + 1 < g.cols ? j + 1 : 0;
+    int n = g.get(up, left) + g.get(up, j) + g.get(up, right) + g.get(i, left) + g.get(i, right) +
+            g.get(dn, left) + g.get(dn, j) + g.get(dn, right);
+    return rule.next(g.get(i, j), n);
+}
+
+// Function to recompute the cells on the edges of the grid (first/last row or column) inside rows
+// [first_row, last_row] and columns [first_col, last_col] of next_state for a toroidal grid. Everywhere else a torus
+// step is the same as a closed one, so the packed engines only need this fix-up afterwards.
+void wrap_packed_edges(const PackedGrid& current_state, PackedGrid& next_state, int first_row, int last_row,
+                       int first_col, int last_col, const LifeRule& rule) {
+    int rows = current_state.rows, cols = current_state.cols;
+    for (int i = first_row; i <= last_row; ++i) {
+        if (i == 0 || i == rows - 1) {
+            for (int j = first_col; j <= last_col; ++j) {
+                next_state.set(i, j, wrapped_next_cell(current_state, i, j, rule));
+            }
+            continue;
+        }
+        if (first_col == 0) next_state.set(i, 0, wrapped_next_cell(current_state, i, 0, rule));
+        if (last_col == cols - 1) next_state.set(i, cols - 1, wrapped_next_cell(current_state, i, cols - 1, rule));
+    }
+}
+
+// Function to calculate the next game state from a packed game state under a rule, with dead boundaries or (wrap) as
+// a torus. next_state must have the same dimensions as current_state and must not alias it.
+void calc_packed_state(const PackedGrid& current_state, PackedGrid& next_state, bool wrap, const LifeRule& rule) {
+    rule_engine(rule)(current_state, next_state, rule);
+    if (wrap) {
+        wrap_packed_edges(current_state, next_state, 0, current_state.rows - 1, 0, current_state.cols - 1, rule);
+    }
+}
+
+PackedGrid calc_packed_state(const PackedGrid& current_state, bool wrap, const LifeRule& rule) {
+    PackedGrid next_state(current_state.rows, current_state.cols);
+    calc_packed_state(current_state, next_state, wrap, rule);
+    return next_state;
+}
+
+// Function to hash a packed game state (all real words, row by row)
+uint64_t hash_grid(const PackedGrid& grid) {
+    return grid.hash();
+}
+
+uint64_t hash_rows(const uint64_t* row0, int rows, int cols, int stride) {
+    uint64_t h = (uint64_t(rows) << 32) ^ uint64_t(cols);
+    int words_per_row = (cols + 63) / 64;
+    for (int i = 0; i < rows; ++i) {
+        const uint64_t* row = row0 + size_t(i) * stride;
+        for (int w = 0; w < words_per_row; ++w) {
+            h ^= row[w];
+            h *= 0x9E3779B97F4A7C15ull;
+            h ^= h >> 29;
+        }
+    }
+    return h;
+}
+
+// Function to compare two equally sized packed game states. Returns the number of differing cells and sets row/col to
+// the first difference in row-major order (left alone when the grids are equal).
+long first_difference(const PackedGrid& a, const PackedGrid& b, int& row, int& col) {
+    return first_difference_rows(a, b.row(0), b.stride, row, col);
+}
+
+long first_difference_rows(const PackedGrid& a, const uint64_t* row0, int stride, int& row, int& col) {
+    long cells = 0;
+    for (int i = 0; i < a.rows; ++i) {
+        const uint64_t* ra = a.row(i);
+        const uint64_t* rb = row0 + size_t(i) * stride;
+        for (int w = 0; w < a.words_per_row; ++w) {
+            uint64_t diff = ra[w] ^ rb[w];
+            if (!diff) continue;
+            if (!cells) {
+                row = i;
+                col = 64 * w + __builtin_ctzll(diff);
+            }
+            cells += __builtin_popcountll(diff);
+        }
+    }
+    return cells;
+}
+
+void unpack_flat_cells(const void* cells, size_t bytes, PackedGrid& grid) {
+    static thread_local vector<uint64_t> flat;
+    flat.assign((bytes + 7) / 8 + 1, 0);    // one spare word so every row can read a whole word past its end
+    memcpy(flat.data(), cells, bytes);
+
+    for (int i = 0; i < grid.rows; ++i) {
+        uint64_t* row = grid.row(i);
+        for (int w = 0; w < grid.words_per_row; ++w) {
+            size_t pos = size_t(grid.cols) * i + 64 * w;
+            size_t q = pos >> 6, r = pos & 63;
+            row[w] = r ? (flat[q] >> r) | (flat[q + 1] << (64 - r)) : flat[q];
+        }
+        // The bits after the last column belong to the next row
+        if (grid.cols & 63) row[grid.words_per_row - 1] &= (uint64_t(1) << (grid.cols & 63)) - 1;
+    }
+}
+
+bool CycleDetector::add(const PackedGrid& state, long generation) {
+    if (period) return false;
+
+    // Confirm a pending candidate once a full candidate period has gone by
+    if (candidate_gen >= 0 && generation == candidate_gen + candidate_period) {
+        if (state == candidate) {
+            first_repeat = candidate_gen;
+            period = candidate_period;
+            return true;
+        }
+        candidate_gen = -1;          // hash collision, keep looking
+    }
+
+    uint64_t h = hash_grid(state);
+    auto it = first_seen.find(h);
+    if (it == first_seen.end()) {
+        first_seen.emplace(h, generation);
+    } else if (candidate_gen < 0) {
+        candidate.copy_from(state);
+        candidate_gen = generation;
+        candidate_period = generation - it->second;
+    }
+    return false;
+}
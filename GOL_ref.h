@@ -0,0 +1,242 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <string>
+#include <new>
+#include <stdint.h>
+#include <stddef.h>
+
+using namespace std;
+
+// Allocator for cache line (64-byte) aligned storage
+template <class T>
+struct CacheAlignedAllocator {
+    typedef T value_type;
+    CacheAlignedAllocator() = default;
+    template <class U> CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), align_val_t(64))); }
+    void deallocate(T* p, size_t) { ::operator delete(p, align_val_t(64)); }
+    template <class U> bool operator==(const CacheAlignedAllocator<U>&) const { return true; }
+    template <class U> bool operator!=(const CacheAlignedAllocator<U>&) const { return false; }
+};
+
+// View of the real words of one packed row (like a span: it owns nothing and is only valid while the grid is)
+template <class Word>
+struct PackedRowView {
+    Word* words;
+    int cols;
+
+    int size() const { return (cols + 63) / 64; }
+    Word* begin() const { return words; }
+    Word* end() const { return words + size(); }
+    Word& operator[](int w) const { return words[w]; }
+    bool get(int j) const { return (words[j >> 6] >> (j & 63)) & 1; }
+    long population() const {
+        long n = 0;
+        for (int w = 0; w < size(); ++w) n += __builtin_popcountll(words[w]);
+        return n;
+    }
+};
+
+// Packed game state, used by the testbench, the GUI and the reference model. Each row holds 64 cells per word
+// (column j is bit j%64 of word j/64). Rows are padded with at least one zero word to a whole number of cache lines
+// and the grid is framed by zero guard rows above and below, so the neighbor calculation never needs bounds checks and
+// matches the closed, dead boundary of GOL.sv. With GOL.sv's wrap (a torus), the edge cells are recomputed afterwards
+// by wrap_packed_edges. The storage is one cache line aligned block, so every row starts on a cache line.
+// Grids are move-only: they are handed between the DUT, the checker and the GUI without copying, and a copy has to
+// be asked for (clone, or copy_from to reuse a buffer). The hash and population are computed once per state and then
+// kept until the grid is next accessed for writing (row(i) or set on a non-const grid).
+struct PackedGrid {
+    int rows = 0;
+    int cols = 0;
+    int words_per_row = 0;           // words holding real cells
+    int stride = 0;                  // words per stored row (including zero padding)
+
+    PackedGrid() = default;
+    PackedGrid(int n, int m);
+    PackedGrid(PackedGrid&&) = default;
+    PackedGrid& operator=(PackedGrid&&) = default;
+    PackedGrid(const PackedGrid&) = delete;
+    PackedGrid& operator=(const PackedGrid&) = delete;
+
+    PackedGrid clone() const;
+    void copy_from(const PackedGrid& other);   // no allocation when the sizes already match
+    void clear();                              // all cells dead
+
+    // Row i in [-1, rows] (-1 and rows are the dead guard rows)
+    uint64_t* row(int i) {
+        changed();
+        return bits.data() + 8 + (i + 1) * stride;
+    }
+    const uint64_t* row(int i) const { return bits.data() + 8 + (i + 1) * stride; }
+    PackedRowView<uint64_t> row_view(int i) { return {row(i), cols}; }
+    PackedRowView<const uint64_t> row_view(int i) const { return {row(i), cols}; }
+
+    bool get(int i, int j) const { return (row(i)[j >> 6] >> (j & 63)) & 1; }
+    void set(int i, int j, bool v) {
+        uint64_t mask = uint64_t(1) << (j & 63);
+        if (v) row(i)[j >> 6] |= mask;
+        else row(i)[j >> 6] &= ~mask;
+    }
+
+    uint64_t hash() const;           // hash_grid, cached
+    long population() const;         // live cells, cached
+    size_t memory_bytes() const { return bits.capacity() * sizeof(uint64_t); }
+
+    bool operator==(const PackedGrid& other) const;
+    bool operator!=(const PackedGrid& other) const { return !(*this == other); }
+
+private:
+    void changed() { hash_valid = population_valid = false; }
+
+    vector<uint64_t, CacheAlignedAllocator<uint64_t>> bits;   // guard rows and rows, plus a cache line at each end
+    mutable uint64_t cached_hash = 0;
+    mutable long cached_population = 0;
+    mutable bool hash_valid = false;
+    mutable bool population_valid = false;
+};
+
+// Bit-sliced Game of Life rule for a whole word of cells at once (shared by the reference engines). Inputs are the 8
+// neighbor planes (already shifted so that bit j of each plane is the corresponding neighbor of column j) and the
+// current cell plane. The neighbor count is reduced with carry-save adders:
+//   - the top and bottom rows of the 3x3 window go through a full adder (ones + twos)
+//   - the middle row (left + right) goes through a half adder
+//   - the three ones bits are then full-added, giving the final ones bit s0 and a carry into the twos column
+//   - the count is 2 or 3 exactly when a single one of the four twos bits is set
+// After that, the cell is alive if the count is 3, or the count is 2 and the cell was already alive.
+#define GOL_LIFE_RULE(AND, OR, XOR, ANDNOT, ul, u, ur, l, c, r, dl, d, dr, out) do {   \
+        auto t0_ = XOR(XOR(ul, u), ur);                                                  \
+        auto t1_ = OR(AND(ul, u), AND(ur, XOR(ul, u)));                                  \
+        auto b0_ = XOR(XOR(dl, d), dr);                                                  \
+        auto b1_ = OR(AND(dl, d), AND(dr, XOR(dl, d)));                                  \
+        auto m0_ = XOR(l, r);                                                            \
+        auto m1_ = AND(l, r);                                                            \
+        auto s0_ = XOR(XOR(t0_, b0_), m0_);                                              \
+        auto c0_ = OR(AND(t0_, b0_), AND(m0_, XOR(t0_, b0_)));                           \
+        auto one_ = XOR(XOR(t1_, b1_), XOR(m1_, c0_));                                   \
+        auto k1_ = ANDNOT(OR(AND(t1_, b1_), AND(m1_, c0_)), one_);                       \
+        out = AND(k1_, OR(s0_, c));                                                      \
+    } while (0)
+
+// Life-like rule in B/S notation (e.g. B3/S23, Conway's Life, the default): bit n of birth is set if a dead cell with
+// n alive neighbors comes alive, bit n of survive if an alive cell with n alive neighbors stays alive (n = 0 to 8).
+struct LifeRule {
+    uint16_t birth = 1 << 3;
+    uint16_t survive = 1 << 2 | 1 << 3;
+
+    bool next(bool alive, int neighbors) const { return ((alive ? survive : birth) >> neighbors) & 1; }
+    bool conway() const { return birth == LifeRule().birth && survive == LifeRule().survive; }
+    string name() const;             // "B36/S23"
+
+    bool operator==(const LifeRule& other) const { return birth == other.birth && survive == other.survive; }
+    bool operator!=(const LifeRule& other) const { return !(*this == other); }
+};
+
+// Function to parse a rule in B/S notation ("B36/S23", any case, the '/' optional) or in the older S/B notation
+// ("23/36"). Returns false if text is not a rule.
+bool parse_life_rule(const string& text, LifeRule& rule);
+
+// Bit-sliced life-like rule for a whole word of cells at once, with the same inputs as GOL_LIFE_RULE plus the rule
+// masks and an all-ones constant of the word type. The carry-save adders are carried on until the neighbor count is
+// four bit planes n0..n3 (count = n0 + 2 n1 + 4 n2 + 8 n3). The plane of one count n is then its decoded low two bits
+// (lo0..lo3) ANDed with hi0 (n < 4) or n2 (4 to 7), and eight neighbors is n3 alone. Each count in the rule ORs its
+// plane into the result directly if it is in both masks, else into the births (taken by dead cells) or survivals
+// (taken by live cells).
+// When BIRTH and SURVIVE are compile-time constants (the templated kernels in GOL_ref.cpp) every mask test folds away
+// and only the terms of the rule's counts are left, so the loop around it has no rule branches at all.
+#define GOL_LIFE_LIKE_RULE(BIRTH, SURVIVE, AND, OR, XOR, ANDNOT, ONES, ul, u, ur, l, c, r, dl, d, dr, out) do {   \
+        auto t0_ = XOR(XOR(ul, u), ur);                                                  \
+        auto t1_ = OR(AND(ul, u), AND(ur, XOR(ul, u)));                                  \
+        auto b0_ = XOR(XOR(dl, d), dr);                                                  \
+        auto b1_ = OR(AND(dl, d), AND(dr, XOR(dl, d)));                                  \
+        auto m0_ = XOR(l, r);                                                            \
+        auto m1_ = AND(l, r);                                                            \
+        auto n0_ = XOR(XOR(t0_, b0_), m0_);                                              \
+        auto c0_ = OR(AND(t0_, b0_), AND(m0_, XOR(t0_, b0_)));                           \
+        auto p0_ = XOR(XOR(t1_, b1_), m1_);                                              \
+        auto p1_ = OR(AND(t1_, b1_), AND(m1_, XOR(t1_, b1_)));                           \
+        auto n1_ = XOR(p0_, c0_);                                                        \
+        auto q1_ = AND(p0_, c0_);                                                        \
+        auto n2_ = XOR(p1_, q1_);                                                        \
+        auto n3_ = AND(p1_, q1_);                                                        \
+        auto lo0_ = ANDNOT(OR(n0_, n1_), ONES);                                          \
+        auto lo1_ = ANDNOT(n1_, n0_);                                                    \
+        auto lo2_ = ANDNOT(n0_, n1_);                                                    \
+        auto lo3_ = AND(n0_, n1_);                                                       \
+        auto hi0_ = ANDNOT(OR(n2_, n3_), ONES);                                          \
+        auto both_ = ANDNOT(ONES, ONES), born_ = both_, kept_ = both_;                   \
+        GOL_RULE_TERM_(BIRTH, SURVIVE, OR, 0, AND(lo0_, hi0_));                          \
+        GOL_RULE_TERM_(BIRTH, SURVIVE, OR, 1, AND(lo1_, hi0_));                          \
+        GOL_RULE_TERM_(BIRTH, SURVIVE, OR, 2, AND(lo2_, hi0_));                          \
+        GOL_RULE_TERM_(BIRTH, SURVIVE, OR, 3, AND(lo3_, hi0_));                          \
+        GOL_RULE_TERM_(BIRTH, SURVIVE, OR, 4, AND(lo0_, n2_));                           \
+        GOL_RULE_TERM_(BIRTH, SURVIVE, OR, 5, AND(lo1_, n2_));                           \
+        GOL_RULE_TERM_(BIRTH, SURVIVE, OR, 6, AND(lo2_, n2_));                           \
+        GOL_RULE_TERM_(BIRTH, SURVIVE, OR, 7, AND(lo3_, n2_));                           \
+        GOL_RULE_TERM_(BIRTH, SURVIVE, OR, 8, n3_);                                      \
+        out = OR(both_, OR(ANDNOT(c, born_), AND(c, kept_)));                            \
+    } while (0)
+
+// One count of GOL_LIFE_LIKE_RULE: eq is the plane of cells with exactly n alive neighbors
+#define GOL_RULE_TERM_(BIRTH, SURVIVE, OR, n, eq)                                        \
+    if ((BIRTH) & (SURVIVE) & (1 << (n))) both_ = OR(both_, eq);                         \
+    else if ((BIRTH) & (1 << (n))) born_ = OR(born_, eq);                                \
+    else if ((SURVIVE) & (1 << (n))) kept_ = OR(kept_, eq)
+
+#define GOL_SCALAR_AND(a, b) ((a) & (b))
+#define GOL_SCALAR_OR(a, b) ((a) | (b))
+#define GOL_SCALAR_XOR(a, b) ((a) ^ (b))
+#define GOL_SCALAR_ANDNOT(a, b) (~(a) & (b))
+
+// Function to apply a rule known only at runtime to one word of cells (any unsigned word type), for the engines that
+// don't go through calc_packed_state. Conway's rule takes the shorter GOL_LIFE_RULE.
+template <class Word>
+inline Word life_rule_word(const LifeRule& rule, Word ul, Word u, Word ur, Word l, Word c, Word r, Word dl, Word d,
+                           Word dr) {
+    Word out;
+    if (rule.conway()) {
+        GOL_LIFE_RULE(GOL_SCALAR_AND, GOL_SCALAR_OR, GOL_SCALAR_XOR, GOL_SCALAR_ANDNOT,
+                      ul, u, ur, l, c, r, dl, d, dr, out);
+    } else {
+        GOL_LIFE_LIKE_RULE(rule.birth, rule.survive, GOL_SCALAR_AND, GOL_SCALAR_OR, GOL_SCALAR_XOR, GOL_SCALAR_ANDNOT,
+                           Word(~Word(0)), ul, u, ur, l, c, r, dl, d, dr, out);
+    }
+    return out;
+}
+
+void calc_packed_state(const PackedGrid& current_state, PackedGrid& next_state, bool wrap = false,
+                       const LifeRule& rule = LifeRule());
+PackedGrid calc_packed_state(const PackedGrid& current_state, bool wrap = false, const LifeRule& rule = LifeRule());
+void wrap_packed_edges(const PackedGrid& current_state, PackedGrid& next_state, int first_row, int last_row,
+                       int first_col, int last_col, const LifeRule& rule = LifeRule());
+const char* packed_engine_name();
+// Whether calc_packed_state has a kernel compiled for this rule (the others share one that tests the masks per word)
+bool life_rule_specialized(const LifeRule& rule);
+
+uint64_t hash_grid(const PackedGrid& grid);
+// Same hash for rows stored outside a PackedGrid (rows of `stride` words, the first one at row0), e.g. a snapshot
+uint64_t hash_rows(const uint64_t* row0, int rows, int cols, int stride);
+long first_difference(const PackedGrid& a, const PackedGrid& b, int& row, int& col);
+// Same comparison against rows stored outside a PackedGrid (as for hash_rows), e.g. a mapped snapshot of a's size
+long first_difference_rows(const PackedGrid& a, const uint64_t* row0, int stride, int& row, int& col);
+// Function to copy a flat vector of cells (cell (i, j) at bit cols*i+j, the order of GOL.status, `bytes` long) into
+// grid, one word per row word
+void unpack_flat_cells(const void* cells, size_t bytes, PackedGrid& grid);
+
+// Detects when a sequence of game states starts repeating with any period. The hash of each generation goes into a
+// hash table of first occurrences, so a repeat is found in O(1) per generation. A hit only gives a candidate period P;
+// it is confirmed exactly by checking that the state P generations later equals the state at the hit, so a hash
+// collision can never end a test early.
+struct CycleDetector {
+    long first_repeat = -1;          // generation G whose state equals generation G-period (valid once confirmed)
+    long period = 0;                 // 0 until a cycle is confirmed
+
+    // Add the state of the given generation; returns true on the generation that confirms a cycle
+    bool add(const PackedGrid& state, long generation);
+
+private:
+    unordered_map<uint64_t, long> first_seen;
+    PackedGrid candidate;            // state at the candidate repeat
+    long candidate_gen = -1;
+    long candidate_period = 0;
+};
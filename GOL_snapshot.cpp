@@ -0,0 +1,109 @@
+#include <string>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include "GOL_snapshot.h"
+
+using namespace std;
+
+static const char SNAPSHOT_MAGIC[8] = {'G', 'O', 'L', 'S', 'N', 'A', 'P', '1'};
+
+bool save_snapshot(const string& path, const PackedGrid& grid, uint64_t generation, string& error) {
+    SnapshotHeader header = {};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.rows = grid.rows;
+    header.cols = grid.cols;
+    header.stride = grid.stride;
+    header.generation = generation;
+    header.hash = hash_grid(grid);
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+    size_t words = size_t(grid.rows + 2) * grid.stride;
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              fwrite(grid.row(-1), sizeof(uint64_t), words, f) == words;
+    ok = fclose(f) == 0 && ok;
+    if (!ok) error = path + ": " + strerror(errno);
+    return ok;
+}
+
+bool SnapshotWriter::create(const string& p, int rows, int cols, uint64_t generation, string& error) {
+    path = p;
+    int stride = PackedGrid(0, cols).stride;
+    if (!file.create(path, sizeof(SnapshotHeader) + (size_t(rows) + 2) * stride * sizeof(uint64_t), error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    SnapshotHeader& h = header();
+    memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.rows = rows;
+    h.cols = cols;
+    h.stride = stride;
+    h.generation = generation;
+    return true;
+}
+
+bool SnapshotWriter::finish(string& error) {
+    if (!file.data) return true;
+    header().hash = hash_rows(row(0), header().rows, header().cols, header().stride);
+    if (!file.close(error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+// Function to check that everything outside the cells (guard rows, padding words, bits past the last column) is zero,
+// as the packed engines rely on it and the hash doesn't cover it
+bool MappedSnapshot::padding_is_zero() const {
+    int words_per_row = (cols() + 63) / 64, stride = header().stride;
+    uint64_t tail = (cols() & 63) ? ~((uint64_t(1) << (cols() & 63)) - 1) : 0;
+    for (int i = -1; i <= rows(); ++i) {
+        const uint64_t* r = row(i);
+        int first = (i < 0 || i == rows()) ? 0 : words_per_row;
+        if (first && (r[words_per_row - 1] & tail)) return false;
+        for (int w = first; w < stride; ++w) {
+            if (r[w]) return false;
+        }
+    }
+    return true;
+}
+
+bool MappedSnapshot::open(const string& path, string& error) {
+    if (!file.open(path, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    if (file.size < sizeof(SnapshotHeader) || memcmp(header().magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC))) {
+        error = path + ": not a game state snapshot";
+        return false;
+    }
+    // The stride must be what PackedGrid would use, so the rows can be copied as they are
+    const SnapshotHeader& h = header();
+    if (h.rows > (1u << 24) || h.cols > (1u << 24) || int(h.stride) != PackedGrid(0, h.cols).stride ||
+        file.size != sizeof(SnapshotHeader) + (size_t(h.rows) + 2) * h.stride * sizeof(uint64_t)) {
+        error = path + ": corrupt snapshot header";
+        return false;
+    }
+    if (hash_rows(row(0), h.rows, h.cols, h.stride) != h.hash || !padding_is_zero()) {
+        error = path + ": corrupt snapshot (hash or padding check failed)";
+        return false;
+    }
+    return true;
+}
+
+void MappedSnapshot::copy_to(PackedGrid& grid) const {
+    if (grid.rows != rows() || grid.cols != cols()) grid = PackedGrid(rows(), cols());
+    memcpy(grid.row(-1), row(-1), size_t(rows() + 2) * header().stride * sizeof(uint64_t));
+}
+
+bool load_snapshot(const string& path, PackedGrid& grid, uint64_t& generation, string& error) {
+    MappedSnapshot snapshot;
+    if (!snapshot.open(path, error)) return false;
+    snapshot.copy_to(grid);
+    generation = snapshot.generation();
+    return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <string>
+#include <stdint.h>
+#include "GOL_ref.h"
+#include "GOL_mmap.h"
+
+using namespace std;
+
+// Binary snapshot of one game state (*.golsnap): a 64-byte header followed by the grid exactly as PackedGrid stores
+// it, rows -1 to rows (the zero guard rows included) of `stride` words each. The header is one cache line, so the
+// rows are 64-bit (in fact 64-byte) aligned both in the file and in a mapping of it; they can be read in place, and
+// loading a PackedGrid is a single copy with no unpacking. Values are stored in host byte order.
+struct SnapshotHeader {
+    char magic[8];                   // "GOLSNAP1"
+    uint32_t rows;
+    uint32_t cols;
+    uint32_t stride;                 // words per stored row, as in PackedGrid
+    uint32_t reserved;
+    uint64_t generation;
+    uint64_t hash;                   // hash_grid of the state, checked when the snapshot is opened
+    uint8_t padding[24];
+};
+static_assert(sizeof(SnapshotHeader) == 64, "snapshot header must be one cache line");
+
+// Function to write a game state to a snapshot file. Returns false with a message in error if it can't be written.
+bool save_snapshot(const string& path, const PackedGrid& grid, uint64_t generation, string& error);
+
+// A snapshot file mapped read-only. open() checks the header, the file size, the hash and that the guard rows and
+// padding are zero.
+class MappedSnapshot {
+public:
+    bool open(const string& path, string& error);
+
+    const SnapshotHeader& header() const { return *reinterpret_cast<const SnapshotHeader*>(file.data); }
+    int rows() const { return header().rows; }
+    int cols() const { return header().cols; }
+    uint64_t generation() const { return header().generation; }
+
+    // Row i in [-1, rows], straight from the mapping
+    const uint64_t* row(int i) const {
+        return reinterpret_cast<const uint64_t*>(file.data + sizeof(SnapshotHeader)) + size_t(i + 1) * header().stride;
+    }
+
+    // Function to copy the state into grid (resized to the snapshot's size). The packed engines can't step the
+    // mapping itself: their vector loads run a word past the last guard row, into the cache line a PackedGrid keeps
+    // after its block, which can lie past the end of the file. Read-only users take the rows straight from row().
+    void copy_to(PackedGrid& grid) const;
+
+private:
+    bool padding_is_zero() const;
+
+    MappedFile file;
+};
+
+// A snapshot file created at its full size and mapped writable, so a game state can be written into it row by row
+// without ever being held in memory as a whole (the streaming testbench drains GOLStream into one). Rows start out
+// dead; finish() fills in the hash and flushes the file.
+class SnapshotWriter {
+public:
+    bool create(const string& path, int rows, int cols, uint64_t generation, string& error);
+    bool finish(string& error);
+
+    SnapshotHeader& header() { return *reinterpret_cast<SnapshotHeader*>(file.data); }
+    int stride() { return header().stride; }
+
+    // Row i in [0, rows), straight into the mapping. Bits past the last column must stay zero.
+    uint64_t* row(int i) {
+        return reinterpret_cast<uint64_t*>(file.data + sizeof(SnapshotHeader)) + size_t(i + 1) * header().stride;
+    }
+
+private:
+    WritableMappedFile file;
+    string path;
+};
+
+// Function to load a snapshot file into grid (one copy, see copy_to). Returns false with a message in error if it
+// isn't a valid snapshot.
+bool load_snapshot(const string& path, PackedGrid& grid, uint64_t& generation, string& error);
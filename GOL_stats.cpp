@@ -0,0 +1,92 @@
+#include <string>
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include "GOL_stats.h"
+
+using namespace std;
+
+static const char STATS_MAGIC[8] = {'G', 'O', 'L', 'S', 'T', 'A', 'T', '1'};
+
+void grid_stats(const PackedGrid& state, const PackedGrid* previous, long generation, GenerationStats& stats) {
+    stats = GenerationStats();
+    stats.generation = generation;
+    for (int i = 0; i < state.rows; ++i) {
+        const uint64_t* row = state.row(i);
+        const uint64_t* prev = previous ? previous->row(i) : row;
+        int first = -1, last = -1;
+        for (int w = 0; w < state.words_per_row; ++w) {
+            uint64_t changed = row[w] ^ prev[w];
+            stats.population += __builtin_popcountll(row[w]);
+            stats.births += __builtin_popcountll(changed & row[w]);
+            stats.deaths += __builtin_popcountll(changed & prev[w]);
+            if (row[w]) {
+                if (first < 0) first = w;
+                last = w;
+            }
+        }
+        if (first < 0) continue;
+
+        // Bits past the last column are always zero, so the lowest and highest set bits are real cells
+        int c0 = 64 * first + __builtin_ctzll(row[first]);
+        int c1 = 64 * last + 63 - __builtin_clzll(row[last]);
+        if (stats.min_row < 0) {
+            stats.min_row = i;
+            stats.min_col = c0;
+            stats.max_col = c1;
+        }
+        stats.max_row = i;
+        stats.min_col = min(stats.min_col, c0);
+        stats.max_col = max(stats.max_col, c1);
+    }
+}
+
+StatsWriter::~StatsWriter() {
+    string error;
+    close(error);
+}
+
+bool StatsWriter::open(const string& p, int rows, int cols, string& error) {
+    path = p;
+    csv = path.size() >= 4 && !strcasecmp(path.c_str() + path.size() - 4, ".csv");
+    failed = false;
+    file = fopen(path.c_str(), csv ? "w" : "wb");
+    if (!file) {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+    if (csv) {
+        fputs("generation,population,births,deaths,min_row,max_row,min_col,max_col\n", file);
+    } else {
+        StatsHeader header = {};
+        memcpy(header.magic, STATS_MAGIC, sizeof(header.magic));
+        header.rows = rows;
+        header.cols = cols;
+        header.record_size = sizeof(GenerationStats);
+        failed = fwrite(&header, sizeof(header), 1, file) != 1;
+    }
+    return true;
+}
+
+// Function to append one sample. Errors are remembered and reported by close().
+void StatsWriter::write(const GenerationStats& stats) {
+    if (!file || failed) return;
+    if (csv) {
+        failed = fprintf(file, "%lld,%lld,%lld,%lld,%d,%d,%d,%d\n", (long long)stats.generation,
+                         (long long)stats.population, (long long)stats.births, (long long)stats.deaths,
+                         stats.min_row, stats.max_row, stats.min_col, stats.max_col) < 0;
+    } else {
+        failed = fwrite(&stats, sizeof(stats), 1, file) != 1;
+    }
+}
+
+bool StatsWriter::close(string& error) {
+    if (!file) return true;
+    bool ok = !failed;
+    ok = fclose(file) == 0 && ok;
+    file = nullptr;
+    if (!ok) error = path + ": " + strerror(errno);
+    return ok;
+}
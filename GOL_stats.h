@@ -0,0 +1,57 @@
+#pragma once
+#include <string>
+#include <stdio.h>
+#include <stdint.h>
+#include "GOL_ref.h"
+
+using namespace std;
+
+// Activity statistics of one captured generation. Births and deaths are counted against the previous captured
+// generation (the XOR of the two states), so with --readback-every=K they are the net changes over K ticks.
+struct GenerationStats {
+    int64_t generation = 0;
+    int64_t population = 0;          // live cells
+    int64_t births = 0;              // cells dead in the previous sample and alive in this one
+    int64_t deaths = 0;              // cells alive in the previous sample and dead in this one
+    int32_t min_row = -1;            // bounding box of the live cells (all -1 when there are none)
+    int32_t max_row = -1;
+    int32_t min_col = -1;
+    int32_t max_col = -1;
+};
+static_assert(sizeof(GenerationStats) == 48, "stats records are written as they are");
+
+// Function to compute the stats of state in one pass over its packed rows. previous is the state of the sample
+// before (same size), or null for the first sample, which has no births or deaths.
+void grid_stats(const PackedGrid& state, const PackedGrid* previous, long generation, GenerationStats& stats);
+
+// Header of a binary stats file (*.golstat): one cache line, then one GenerationStats record per sample, in host
+// byte order
+struct StatsHeader {
+    char magic[8];                   // "GOLSTAT1"
+    uint32_t rows;
+    uint32_t cols;
+    uint32_t record_size;            // sizeof(GenerationStats)
+    uint8_t padding[44];
+};
+static_assert(sizeof(StatsHeader) == 64, "stats header must be one cache line");
+
+// Writes the stats of a run as they are produced, so a run never has to keep its history to report them. A path
+// ending in .csv gets one text line per sample (with a column header line), anything else the binary format above.
+class StatsWriter {
+public:
+    StatsWriter() = default;
+    ~StatsWriter();
+    StatsWriter(const StatsWriter&) = delete;
+    StatsWriter& operator=(const StatsWriter&) = delete;
+
+    bool open(const string& path, int rows, int cols, string& error);
+    void write(const GenerationStats& stats);
+    // Returns false with a message in error if anything couldn't be written
+    bool close(string& error);
+
+private:
+    FILE* file = nullptr;
+    bool csv = false;
+    bool failed = false;
+    string path;
+};
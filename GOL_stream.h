@@ -0,0 +1,125 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include "GOL_ref.h"
+#include "GOL_stats.h"
+
+using namespace std;
+
+// Bounded single-producer/single-consumer ring buffer. All slots are made up front by make(); the producer copies
+// into a slot (no allocation once the slot has the right size) and the consumer swaps a slot out, handing its own buffers
+// back to the ring, so a steady stream of equally sized game states never touches the heap.
+template <typename T>
+class SpscRing {
+public:
+    template <typename F>
+    SpscRing(size_t capacity, F&& make) {
+        size_t n = 1;
+        while (n < capacity) n <<= 1;
+        slots.reserve(n);
+        for (size_t i = 0; i < n; ++i) slots.push_back(make());
+        mask = n - 1;
+    }
+
+    // Producer: fill the next free slot with fill(slot); false if the ring is full
+    template <typename F>
+    bool try_produce(F&& fill) {
+        size_t h = head.load(memory_order_relaxed);
+        if (h - tail.load(memory_order_acquire) == slots.size()) return false;
+        fill(slots[h & mask]);
+        head.store(h + 1, memory_order_release);
+        return true;
+    }
+
+    // Consumer: swap the oldest item into item; false if the ring is empty
+    bool try_pop(T& item) {
+        size_t t = tail.load(memory_order_relaxed);
+        if (t == head.load(memory_order_acquire)) return false;
+        swap(item, slots[t & mask]);
+        tail.store(t + 1, memory_order_release);
+        return true;
+    }
+
+    bool empty() const { return tail.load(memory_order_acquire) == head.load(memory_order_acquire); }
+
+private:
+    vector<T> slots;
+    size_t mask = 0;
+    alignas(64) atomic<size_t> head{0};  // next slot the producer writes
+    alignas(64) atomic<size_t> tail{0};  // next slot the consumer reads
+};
+
+struct LiveFrame {
+    long generation = 0;
+    PackedGrid grid;
+    GenerationStats stats;
+};
+
+// Link between the simulation thread and the GUI in live mode. The simulation produces generation g only once the
+// GUI has requested it (or while run_free is set) and pushes every captured generation into the ring; the GUI pops
+// everything that is there and only draws the newest frame, so a slow GUI drops frames instead of stalling the sim
+// for more than one ring's worth of generations.
+struct LiveStream {
+    int rows;
+    int cols;
+    SpscRing<LiveFrame> frames;
+    atomic<long> requested{0};           // last generation the GUI has asked for
+    atomic<bool> run_free{false};        // run without waiting for requests
+    atomic<bool> stop{false};            // set by the GUI to abandon the test
+    atomic<bool> done{false};            // set by the simulation thread once the test has finished
+
+    LiveStream(int n, int m, size_t capacity = 8)
+        : rows(n), cols(m), frames(capacity, [&] { return LiveFrame{0, PackedGrid(n, m)}; }) {}
+
+    // GUI side
+    void request() { requested++; wake(); }
+    void set_run_free(bool on) { run_free = on; wake(); }
+    void cancel() { stop = true; wake(); }
+    // True while frames are queued or the simulation is still working towards a requested generation
+    bool pending(long received) const { return !frames.empty() || (!done && (run_free || requested > received)); }
+
+    // Simulation side: block until generation may be produced; false if the test should stop. If the simulation
+    // then runs on to a later generation (produces, several generations per readback), that counts as requested.
+    bool wait_for(long generation, long produces = 0) {
+        unique_lock<mutex> lock(m);
+        cv.wait(lock, [&] { return stop || run_free || requested >= generation; });
+        if (stop) return false;
+        // Keep requested in step with a free run, so that the next click advances by exactly one step
+        long target = max(generation, produces);
+        long r = requested;
+        while (r < target && !requested.compare_exchange_weak(r, target)) {}
+        return true;
+    }
+
+    // Simulation side: hand a generation to the GUI, waiting while the ring is full; false if the test should stop
+    bool push(long generation, const PackedGrid& grid, const GenerationStats& stats) {
+        auto fill = [&](LiveFrame& frame) {
+            frame.generation = generation;
+            frame.grid.copy_from(grid);
+            frame.stats = stats;
+        };
+        while (!frames.try_produce(fill)) {
+            if (stop) return false;
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    void finish() { done = true; }
+
+private:
+    mutex m;
+    condition_variable cv;
+
+    // The flags are atomics, so take the lock once before notifying so a wait_for that just checked them can't miss
+    // the wake-up
+    void wake() {
+        { lock_guard<mutex> lock(m); }
+        cv.notify_one();
+    }
+};
@@ -1,54 +1,147 @@
 #include "VGOL.h"
+#include "VGOL___024root.h"
 #include <verilated.h>
 #include <stdlib.h>
+#include <stdio.h>
 #include <iostream>
 #include <vector>
 #include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <string.h>
+#include <limits.h>
 #include "GOL_GUI.h"
-#if VM_TRACE
+#include "GOL_ref.h"
+#include "GOL_history.h"
+#include "GOL_stream.h"
+#include "GOL_check.h"
+#include "GOL_pattern.h"
+#include "GOL_snapshot.h"
+#include "GOL_random.h"
+#include "GOL_profile.h"
+#include "GOL_stats.h"
+// Waveform tracing is compiled in by Verilator's --trace (VCD) or --trace-fst (FST) flags, see TRACE in the Makefile.
+// Without either, TraceFile is an opaque type and every trace pointer is simply null.
+#if VM_TRACE_FST
+#include "verilated_fst_c.h"
+typedef VerilatedFstC TraceFile;
+#define TRACE_DEFAULT_FILE "waveform.fst"
+#elif VM_TRACE
 #include "verilated_vcd_c.h"
+typedef VerilatedVcdC TraceFile;
+#define TRACE_DEFAULT_FILE "waveform.vcd"
+#else
+typedef void TraceFile;
+#define TRACE_DEFAULT_FILE ""
 #endif
 
 
+// Grid size, parallel port width, boundary, generations per tick and rule the model was built with (-Grows,
+// -Gcolumns, -Gport_width, -Gwrap, -Ggens_per_tick, -Gbirth, -Gsurvive, see Makefile)
+#ifndef GOL_ROWS
+#define GOL_ROWS 30
+#endif
+#ifndef GOL_COLS
+#define GOL_COLS 30
+#endif
+#ifndef GOL_PORT_WIDTH
+#define GOL_PORT_WIDTH 1
+#endif
+#ifndef GOL_WRAP
+#define GOL_WRAP 0
+#endif
+#ifndef GOL_GENS_PER_TICK
+#define GOL_GENS_PER_TICK 1
+#endif
+#ifndef GOL_BIRTH
+#define GOL_BIRTH 0x008
+#endif
+#ifndef GOL_SURVIVE
+#define GOL_SURVIVE 0x00C
+#endif
+
 using namespace std;
-vluint64_t sim_time = 0; // sim time 
+
+// Sim time window in which trace dumps are written (inclusive, set by --trace-time=first:last)
+vluint64_t trace_start = 0;
+vluint64_t trace_stop = ~vluint64_t(0);
 
 
 // Function to update SystemVerilog RTL
 // 1. evaluates all RTL logic
-// 2. dump trace for vcd waveform
+// 2. dump trace for vcd/fst waveform (skipped if tfp is null or sim_time is outside the trace window)
 // 3. increment simulation time
-void updateRTL(VGOL* dut, vluint64_t &sim_time, VerilatedVcdC* tfp) {
+void updateRTL(VGOL* dut, vluint64_t &sim_time, TraceFile* tfp) {
     dut->eval();
-    tfp->dump(sim_time);
+    GOL_PROFILE_COUNT(evals, 1);
+#if VM_TRACE
+    if (tfp && sim_time >= trace_start && sim_time <= trace_stop) {
+        GOL_PROFILE_SCOPE(PHASE_TRACE);
+        tfp->dump(sim_time);
+    }
+#endif
     sim_time++;
 }
 
+// Function to check whether any dump would be written for sim times first..last
+bool tracing(TraceFile* tfp, vluint64_t first, vluint64_t last) {
+#if VM_TRACE
+    return tfp && last >= trace_start && first <= trace_stop;
+#else
+    return false;
+#endif
+}
+
+// Function to advance the DUT by n clock cycles with its current inputs (two evals per cycle: the rising edge, and
+// the falling edge Verilator needs to see the next rising one). With Shift, ShiftPar and NextTimeTick all low, no cell
+// changes on a clock edge, so unless those cycles are traced no evals are needed at all: only sim time moves on, and
+// the next active cycle evaluates any input changes together with its edge.
+void tick(VGOL* dut, vluint64_t &sim_time, TraceFile* tfp, long n = 1) {
+    bool idle = !dut->Shift && !dut->ShiftPar && !dut->NextTimeTick;
+    if (idle && !tracing(tfp, sim_time, sim_time + 2 * n - 1)) {
+        sim_time += 2 * n;
+        return;
+    }
+    for (long c = 0; c < n; ++c) {
+        dut->clock = 1;
+        updateRTL(dut, sim_time, tfp);
+        dut->clock = 0;
+        updateRTL(dut, sim_time, tfp);
+    }
+}
+
+// Function to clock n bits through the serial shift chain (Shift high). Cycle k drives DataIn with in[k], or with
+// DataOut when in is null (recirculating the chain), and stores DataOut as it was before the edge in out[k] if out
+// isn't null. Shift is low again afterwards.
+void shift_bits(VGOL* dut, vluint64_t &sim_time, TraceFile* tfp, const uint8_t* in, uint8_t* out, long n) {
+    dut->Shift = 1;
+    for (long k = 0; k < n; ++k) {
+        uint8_t bit = dut->DataOut;
+        if (out) out[k] = bit;
+        dut->DataIn = in ? in[k] : bit;
+        tick(dut, sim_time, tfp);
+    }
+    dut->Shift = 0;
+}
+
 // Function to generate random n*m game state
 // n rows 
 // m cols
-vector<vector<bool>> generate_stimulus(int n, int m) {
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> dis(0, 1);
-    vector<vector<bool>> stimulus(n, vector<bool>(m));
-
-    for (int i = 0; i < n; ++i) {
-        for (int j = 0; j < m; ++j) {
-            stimulus[i][j] = dis(gen);
-        }
-    }
-
-    return stimulus;
+// seed fully determines the stimulus, so any failing test can be re-run on its own. The grid is drawn 64 cells at a
+// time by random_grid (GOL_random.cpp), with each cell alive with probability density.
+PackedGrid generate_stimulus(int n, int m, uint64_t seed, double density) {
+    return random_grid(n, m, seed, density);
 }
 
 // Function to initialize a p46 gun in the Game of Life
-vector<vector<bool>> p46_gun(int n, int m) {
-    vector<vector<bool>> gun(n, vector<bool>(m, false));
+PackedGrid p46_gun(int n, int m) {
+    PackedGrid gun(n, m);
 
     auto set_cell = [&](int row, int col) {
         if (row >= 0 && row < n && col >= 0 && col < m) {
-            gun[row][col] = true;
+            gun.set(row, col, true);
         }
     };
 
@@ -102,32 +195,84 @@ vector<vector<bool>> p46_gun(int n, int m) {
 }
 
 // Function to apply stimulus game state to the GOL DUT  
-void apply_stimulus(VGOL* dut, vector<vector<bool>>& stimulus, vluint64_t &sim_time, VerilatedVcdC* tfp) {
-    // Send shift high to indicate we are loading in game state
-    dut->Shift = 1;
-    for (int i = stimulus.size()-1; i >= 0; --i) {
-        for (int j = stimulus[0].size()-1; j >= 0; --j) {
-            dut->DataIn = stimulus[i][j];
-            dut->clock = 1;
-            updateRTL(dut, sim_time, tfp);
-            dut->clock = 0;
-            updateRTL(dut, sim_time, tfp);
+void apply_stimulus(VGOL* dut, const PackedGrid& stimulus, vluint64_t &sim_time, TraceFile* tfp) {
+    GOL_PROFILE_SCOPE(PHASE_APPLY);
+    // Lay the cells out in shift order (bottom-right cell first), then shift them all in
+    static thread_local vector<uint8_t> bits;
+    bits.clear();
+    for (int i = stimulus.rows-1; i >= 0; --i) {
+        for (int j = stimulus.cols-1; j >= 0; --j) bits.push_back(stimulus.get(i, j));
+    }
+    shift_bits(dut, sim_time, tfp, bits.data(), nullptr, bits.size());
+    // Hold for 1 clock
+    tick(dut, sim_time, tfp);
+}
+
+// Function to drive port_width cells of one row onto DataInPar, starting at column col
+void set_parallel_in(VGOL* dut, PackedRowView<const uint64_t> row, int col) {
+#if GOL_PORT_WIDTH > 64
+    // Ports wider than 64 bits are exposed by Verilator as an array of 32-bit words
+    for (int w = 0; w < (GOL_PORT_WIDTH + 31) / 32; ++w) dut->DataInPar[w] = 0;
+    for (int k = 0; k < GOL_PORT_WIDTH; ++k) {
+        if (row.get(col + k)) dut->DataInPar[k >> 5] |= 1u << (k & 31);
+    }
+#else
+    uint64_t bits = 0;
+    for (int k = 0; k < GOL_PORT_WIDTH; ++k) {
+        if (row.get(col + k)) bits |= uint64_t(1) << k;
+    }
+    dut->DataInPar = bits;
+#endif
+}
+
+// Function to read port_width cells from DataOutPar into one row (cleared beforehand), starting at column col
+void get_parallel_out(VGOL* dut, PackedRowView<uint64_t> row, int col) {
+    for (int k = 0; k < GOL_PORT_WIDTH; ++k) {
+#if GOL_PORT_WIDTH > 64
+        uint64_t bit = (dut->DataOutPar[k >> 5] >> (k & 31)) & 1;
+#else
+        uint64_t bit = (uint64_t(dut->DataOutPar) >> k) & 1;
+#endif
+        row[(col + k) >> 6] |= bit << ((col + k) & 63);
+    }
+}
+
+// Function to apply stimulus game state to the GOL DUT through the parallel port.
+// Same chain order as apply_stimulus, but port_width cells are loaded per clock.
+void apply_stimulus_parallel(VGOL* dut, const PackedGrid& stimulus, vluint64_t &sim_time, TraceFile* tfp) {
+    GOL_PROFILE_SCOPE(PHASE_APPLY);
+    // Send parallel shift high to indicate we are loading in game state
+    dut->ShiftPar = 1;
+    for (int i = stimulus.rows-1; i >= 0; --i) {
+        for (int j = stimulus.cols-GOL_PORT_WIDTH; j >= 0; j -= GOL_PORT_WIDTH) {
+            set_parallel_in(dut, stimulus.row_view(i), j);
+            tick(dut, sim_time, tfp);
         }
     }
     // Reset shift logic and hold for 1 clock
-    dut->Shift = 0;
-    dut->clock = 1;
-    updateRTL(dut, sim_time, tfp);
-    dut->clock = 0;
-    updateRTL(dut, sim_time, tfp);
+    dut->ShiftPar = 0;
+    tick(dut, sim_time, tfp);
+}
+
+// Function to advance the DUT by one NextTimeTick (GOL_GENS_PER_TICK generations)
+void next_time_tick(VGOL* dut, vluint64_t &sim_time, TraceFile* tfp) {
+    GOL_PROFILE_SCOPE(PHASE_TICK);
+    GOL_PROFILE_COUNT(generations, GOL_GENS_PER_TICK);
+    // Toggle NextTimeTick for one clock cycle
+    dut->NextTimeTick = 1;
+    tick(dut, sim_time, tfp);
+
+    // Reset NextTimeTick and stall for one clock
+    dut->NextTimeTick = 0;
+    tick(dut, sim_time, tfp);
 }
 
 // Function to print grid (for debug purposes)
-void print_grid(const char* label, vector<vector<bool>>& stimulus) {
+void print_grid(const char* label, const PackedGrid& stimulus) {
     cout << label << "\n";
-    for (int i = 0; i < stimulus.size(); ++i) {
-        for (int j = 0; j < stimulus[0].size(); ++j) {
-            cout << stimulus[i][j] << " ";
+    for (int i = 0; i < stimulus.rows; ++i) {
+        for (int j = 0; j < stimulus.cols; ++j) {
+            cout << stimulus.get(i, j) << " ";
         }
         cout << "\n";
     }
@@ -135,179 +280,664 @@ void print_grid(const char* label, vector<vector<bool>>& stimulus) {
 
 // Function to capture DUT output game state
 // DUT game state will be stored in the variable game_state
-void capture_game_state(VGOL* dut, vector<vector<bool>>& game_state, vluint64_t &sim_time, VerilatedVcdC* tfp) {
-    // Send shift signal high to shift out gamestate
-    dut->Shift = 1;
-    for (int i = game_state.size()-1; i >= 0; --i) {
-        for (int j = game_state[0].size()-1; j >= 0; --j) {
-            game_state[i][j] = dut->DataOut;
-            dut->DataIn = dut->DataOut;
-            dut->clock = 1;
-            updateRTL(dut, sim_time, tfp);
-            dut->clock = 0;
-            updateRTL(dut, sim_time, tfp);
+void capture_game_state(VGOL* dut, PackedGrid& game_state, vluint64_t &sim_time, TraceFile* tfp) {
+    GOL_PROFILE_SCOPE(PHASE_CAPTURE);
+    // Shift the whole chain out, feeding it back in the other end, then place the bits (bottom-right cell first)
+    static thread_local vector<uint8_t> bits;
+    bits.resize(size_t(game_state.rows) * game_state.cols);
+    shift_bits(dut, sim_time, tfp, nullptr, bits.data(), bits.size());
+    game_state.clear();
+    size_t k = 0;
+    for (int i = game_state.rows-1; i >= 0; --i) {
+        uint64_t* row = game_state.row(i);
+        for (int j = game_state.cols-1; j >= 0; --j) row[j >> 6] |= uint64_t(bits[k++]) << (j & 63);
+    }
+    // Hold for 1 clock
+    tick(dut, sim_time, tfp);
+}
 
+
+// Function to capture DUT output game state through the parallel port
+// DUT game state will be stored in the variable game_state
+void capture_game_state_parallel(VGOL* dut, PackedGrid& game_state, vluint64_t &sim_time, TraceFile* tfp) {
+    GOL_PROFILE_SCOPE(PHASE_CAPTURE);
+    // Send parallel shift signal high to shift out gamestate, feeding it back in the other end
+    game_state.clear();
+    dut->ShiftPar = 1;
+    for (int i = game_state.rows-1; i >= 0; --i) {
+        for (int j = game_state.cols-GOL_PORT_WIDTH; j >= 0; j -= GOL_PORT_WIDTH) {
+            get_parallel_out(dut, game_state.row_view(i), j);
+            dut->DataInPar = dut->DataOutPar;
+            tick(dut, sim_time, tfp);
         }
     }
     // Reset shift logic and hold for 1 clock
-    dut->Shift = 0;
-    dut->clock = 1;
-    updateRTL(dut, sim_time, tfp);
-    dut->clock = 0;
-    updateRTL(dut, sim_time, tfp);
+    dut->ShiftPar = 0;
+    tick(dut, sim_time, tfp);
 }
 
+// Function to capture DUT game state straight from the public GOL.status vector (no shifting, no clocks).
+// The status words are copied out in a single memcpy, then each row's bit range is moved into its packed row.
+// Cell (i, j) is status bit columns*i+j, the same order the shift chain uses.
+void capture_game_state_fast(VGOL* dut, PackedGrid& game_state) {
+    GOL_PROFILE_SCOPE(PHASE_CAPTURE);
+    unpack_flat_cells(&dut->rootp->GOL__DOT__status, sizeof(dut->rootp->GOL__DOT__status), game_state);
+}
 
-// Function to manually calculate the next predicted game state. 
-// Used to verify correctness of DUT.
-vector<vector<bool>> calc_game_state(const vector<vector<bool>>& current_state) {
-    int rows = current_state.size();
-    int cols = current_state[0].size();
-    
-    // Create a new grid to hold the next state
-    vector<vector<bool>> next_state(rows, vector<bool>(cols, false));
-
-    // Helper lambda to count the live neighbors of a cell
-    auto count_live_neighbors = [&](int row, int col) -> int {
-        int live_neighbors = 0;
-
-        // Check all 8 neighbors (diagonals, horizontal, vertical)
-        for (int i = -1; i <= 1; ++i) {
-            for (int j = -1; j <= 1; ++j) {
-                // Skip the center cell itself
-                if (i == 0 && j == 0) continue;
-
-                int new_row = row + i;
-                int new_col = col + j;
-
-                // Check bounds of the grid
-                if (new_row >= 0 && new_row < rows && new_col >= 0 && new_col < cols) {
-                    if (current_state[new_row][new_col]) {
-                        live_neighbors++;
-                    }
-                }
+// Function to report a generation that differs from the reference model (called on the checker thread, so the
+// message is built first and written in one go). Generations count from first_generation (non-zero when resuming).
+// Unless snapshot_dir is null, the DUT and reference states are saved there as snapshots, along with the reference
+// one generation earlier, which --resume=FILE can start the test again from.
+void report_mismatch(const Mismatch& mismatch, long t, const char* snapshot_dir, long first_generation) {
+    long gen = first_generation + mismatch.generation;
+    string msg = "ERROR on Test#" + to_string(t + 1) + " Iteration #" + to_string(gen) + ": cell (" +
+                 to_string(mismatch.row) + ", " + to_string(mismatch.col) + ") should be " +
+                 (mismatch.expected ? "alive" : "dead") + ", " + to_string(mismatch.cells) + " cell(s) differ\n";
+    if (snapshot_dir) {
+        string base = string(snapshot_dir) + "/mismatch_t" + to_string(t + 1) + "_g", error;
+        string dut_path = base + to_string(gen) + "_dut.golsnap";
+        string ref_path = base + to_string(gen) + "_ref.golsnap";
+        string previous_path = base + to_string(gen - 1) + ".golsnap";
+        bool ok = save_snapshot(dut_path, *mismatch.dut, gen, error) &&
+                  save_snapshot(ref_path, *mismatch.reference, gen, error) &&
+                  (!mismatch.previous || save_snapshot(previous_path, *mismatch.previous, gen - 1, error));
+        if (!ok) msg += "  couldn't save snapshots: " + error + "\n";
+        else {
+            msg += "  saved " + dut_path + " and " + ref_path + "\n";
+            if (mismatch.previous) msg += "  re-run from the generation before with --resume=" + previous_path + "\n";
+        }
+    }
+    cout << msg << flush;
+}
+
+// What to do once the DUT state is found to cycle (--on-cycle=stop|skip|off)
+enum CycleMode { CYCLE_STOP, CYCLE_SKIP, CYCLE_OFF };
+
+// Testbench options, see README.md for the command line
+struct TbOptions {
+    bool parallel_port = false;          // --port=parallel
+    bool fast_readback = false;          // --readback=fast
+    int shift_check = 16;                // --shift-check=K
+    bool trace = VM_TRACE;               // --no-trace
+    const char* trace_file = TRACE_DEFAULT_FILE;
+    int trace_depth = 99;
+    long trace_gen_start = 0;            // --trace-gens=first:last
+    long trace_gen_stop = -1;            // -1 = no limit
+    bool headless = false;               // --headless
+    bool live = true;                    // GUI runs the simulation live (--replay: run the test, then browse it)
+    long seeds = 1000;                   // --seeds=N, number of random stimuli in headless mode
+    double density = 0.5;                // --density=P, live cell probability of random stimuli
+    int jobs = 1;                        // --jobs=N, regression worker threads (0 = one per core)
+    int generations = 200;               // --gens=N, generation limit per stimulus
+    int readback_every = 1;              // --readback-every=K, ticks the DUT runs between readbacks
+    CycleMode on_cycle = CYCLE_STOP;     // --on-cycle=stop|skip|off
+    bool tile_engine = false;            // --ref-engine=tiles, step the reference with the tile-skipping engine
+    int keyframe_interval = 64;          // --keyframe-interval=K, full grid kept every K generations of GUI history
+    bool fixed_seed = false;             // --seed=S
+    uint64_t seed = 0;
+    const char* snapshot_dir = ".";      // --snapshot-dir=DIR, where mismatches are saved (--no-snapshots: nowhere)
+    const char* resume_file = nullptr;   // --resume=FILE, the stimulus is this snapshot
+    PackedGrid resume_state;
+    long resume_generation = 0;          // generation of the snapshot, added to reported generations
+    vector<string> patterns;             // pattern files (or directories of them) given on the command line
+    PatternPlacement placement;          // --pattern-offset=ROW,COL|center
+    long bench_cycles = 0;               // --bench-eval=N, time N free-running clocks instead of testing
+    const char* profile_json = nullptr;  // --profile-json=FILE, also write the phase breakdown as JSON (PROFILE=1)
+    const char* stats_file = nullptr;    // --stats=FILE, per-generation stats of each test (.csv or binary)
+    int rows = GOL_ROWS;                 // --grid=ROWSxCOLS, must match the built model
+    int columns = GOL_COLS;
+    bool wrap = GOL_WRAP;                // toroidal grid, fixed by the model (make WRAP=1)
+    int gens_per_tick = GOL_GENS_PER_TICK; // generations per NextTimeTick, fixed by the model (make GENS=G)
+    LifeRule rule{GOL_BIRTH, GOL_SURVIVE}; // --rule=B/S, must match the built model (make RULE=B36/S23)
+};
+
+// Function to parse the testbench command line (Verilator +args are left to Verilated::commandArgs)
+TbOptions parse_options(int argc, char** argv) {
+    TbOptions opts;
+    bool generations_given = false;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (!strcmp(arg, "--port=parallel")) opts.parallel_port = true;
+        else if (!strcmp(arg, "--port=serial")) opts.parallel_port = false;
+        else if (!strcmp(arg, "--readback=fast")) opts.fast_readback = true;
+        else if (!strcmp(arg, "--readback=shift")) opts.fast_readback = false;
+        else if (!strncmp(arg, "--shift-check=", 14)) opts.shift_check = atoi(arg + 14);
+        else if (!strcmp(arg, "--no-trace")) opts.trace = false;
+        else if (!strncmp(arg, "--trace-file=", 13)) opts.trace_file = arg + 13;
+        else if (!strncmp(arg, "--trace-depth=", 14)) opts.trace_depth = atoi(arg + 14);
+        else if (!strncmp(arg, "--trace-time=", 13)) {
+            unsigned long long first = 0, last = ~0ull;
+            sscanf(arg + 13, "%llu:%llu", &first, &last);
+            trace_start = first;
+            trace_stop = last;
+        }
+        else if (!strncmp(arg, "--trace-gens=", 13)) {
+            sscanf(arg + 13, "%ld:%ld", &opts.trace_gen_start, &opts.trace_gen_stop);
+        }
+        else if (!strcmp(arg, "--headless")) opts.headless = true;
+        else if (!strncmp(arg, "--seeds=", 8)) opts.seeds = atol(arg + 8);
+        else if (!strncmp(arg, "--jobs=", 7)) opts.jobs = atoi(arg + 7);
+        else if (!strncmp(arg, "--density=", 10)) opts.density = atof(arg + 10);
+        else if (!strcmp(arg, "--replay")) opts.live = false;
+        else if (!strncmp(arg, "--gens=", 7)) {
+            generations_given = true;
+            opts.generations = atoi(arg + 7);
+        }
+        else if (!strncmp(arg, "--keyframe-interval=", 20)) opts.keyframe_interval = atoi(arg + 20);
+        else if (!strncmp(arg, "--readback-every=", 17)) opts.readback_every = atoi(arg + 17);
+        else if (!strcmp(arg, "--on-cycle=stop")) opts.on_cycle = CYCLE_STOP;
+        else if (!strcmp(arg, "--on-cycle=skip")) opts.on_cycle = CYCLE_SKIP;
+        else if (!strcmp(arg, "--on-cycle=off")) opts.on_cycle = CYCLE_OFF;
+        else if (!strcmp(arg, "--ref-engine=packed")) opts.tile_engine = false;
+        else if (!strcmp(arg, "--ref-engine=tiles")) opts.tile_engine = true;
+        else if (!strncmp(arg, "--seed=", 7)) {
+            opts.fixed_seed = true;
+            opts.seed = strtoull(arg + 7, nullptr, 0);
+        }
+        else if (!strncmp(arg, "--bench-eval=", 13)) opts.bench_cycles = atol(arg + 13);
+        else if (!strncmp(arg, "--profile-json=", 15)) opts.profile_json = arg + 15;
+        else if (!strncmp(arg, "--stats=", 8)) opts.stats_file = arg + 8;
+        else if (!strncmp(arg, "--grid=", 7)) sscanf(arg + 7, "%dx%d", &opts.rows, &opts.columns);
+        else if (!strncmp(arg, "--rule=", 7)) {
+            if (!parse_life_rule(arg + 7, opts.rule)) {
+                cerr << "Unknown rule " << arg + 7 << " (expected B/S notation, e.g. B36/S23)" << endl;
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (!strncmp(arg, "--snapshot-dir=", 15)) opts.snapshot_dir = arg + 15;
+        else if (!strcmp(arg, "--no-snapshots")) opts.snapshot_dir = nullptr;
+        else if (!strncmp(arg, "--resume=", 9)) opts.resume_file = arg + 9;
+        else if (!strcmp(arg, "--pattern-offset=center")) opts.placement.center = true;
+        else if (!strncmp(arg, "--pattern-offset=", 17)) {
+            opts.placement.center = false;
+            sscanf(arg + 17, "%d,%d", &opts.placement.row, &opts.placement.col);
+        }
+        else if (arg[0] == '-' && arg[1] == '-') {
+            cerr << "Unknown option " << arg << endl;
+            exit(EXIT_FAILURE);
+        }
+        else if (arg[0] != '-' && arg[0] != '+') {
+            string error;
+            if (!add_pattern_paths(arg, opts.patterns, error)) {
+                cerr << error << endl;
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    // The grid size and rule are parameters of the Verilated model, so they can only be checked here, not changed
+    if (opts.rows != GOL_ROWS || opts.columns != GOL_COLS) {
+        cerr << "Model was built for a " << GOL_ROWS << "x" << GOL_COLS << " grid, rebuild with make ROWS="
+             << opts.rows << " COLS=" << opts.columns << endl;
+        exit(EXIT_FAILURE);
+    }
+    LifeRule model_rule{GOL_BIRTH, GOL_SURVIVE};
+    if (opts.rule != model_rule) {
+        cerr << "Model was built for rule " << model_rule.name() << ", rebuild with make RULE=" << opts.rule.name()
+             << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (opts.resume_file) {
+        uint64_t generation = 0;
+        string error;
+        if (!load_snapshot(opts.resume_file, opts.resume_state, generation, error)) {
+            cerr << error << endl;
+            exit(EXIT_FAILURE);
+        }
+        if (opts.resume_state.rows != opts.rows || opts.resume_state.cols != opts.columns) {
+            cerr << opts.resume_file << " holds a " << opts.resume_state.rows << "x" << opts.resume_state.cols
+                 << " grid, the model was built for " << opts.rows << "x" << opts.columns << endl;
+            exit(EXIT_FAILURE);
+        }
+        opts.resume_generation = generation;
+        opts.patterns.clear();
+    }
+    if (opts.generations < 1 || opts.readback_every < 1 || opts.seeds < 0 || opts.density < 0 || opts.density > 1) {
+        cerr << "--gens and --readback-every must be at least 1, --seeds must not be negative and --density must be "
+                "in [0, 1]" << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (opts.parallel_port && opts.columns % GOL_PORT_WIDTH != 0) {
+        cerr << "port_width (" << GOL_PORT_WIDTH << ") must divide columns (" << opts.columns << ")" << endl;
+        exit(EXIT_FAILURE);
+    }
+    // The DUT can only stop on a multiple of its generations per tick
+    int partial_tick = opts.generations % opts.gens_per_tick;
+    if (partial_tick) opts.generations += opts.gens_per_tick - partial_tick;
+    // The live GUI has no history to fill up, so it runs until the test ends or the user moves on. Skipping ahead
+    // needs a generation limit, so without one a confirmed cycle just stops the test.
+    if (opts.headless || opts.bench_cycles > 0) opts.live = false;
+    if (opts.live && !generations_given) {
+        opts.generations = INT_MAX;
+        if (opts.on_cycle == CYCLE_SKIP) opts.on_cycle = CYCLE_STOP;
+    }
+    if (opts.jobs <= 0) opts.jobs = max(1u, thread::hardware_concurrency());
+    if (!opts.fixed_seed) opts.seed = random_device{}();
+    return opts;
+}
+
+// Function to build stimulus i: the --resume snapshot, pattern file i when pattern files were given, otherwise the
+// random stimulus for seed opts.seed + i. Returns false (after printing why) if the pattern can't be loaded.
+bool make_stimulus(const TbOptions& opts, long i, PackedGrid& game_state) {
+    GOL_PROFILE_SCOPE(PHASE_STIMULUS);
+    if (opts.resume_file) {
+        game_state = opts.resume_state.clone();
+        return true;
+    }
+    if (opts.patterns.empty()) {
+        game_state = generate_stimulus(opts.rows, opts.columns, opts.seed + i, opts.density);
+        return true;
+    }
+    game_state = PackedGrid(opts.rows, opts.columns);
+    string error;
+    bool ok = load_pattern(opts.patterns[i], game_state, opts.placement, opts.rule, error);
+    if (!ok) cerr << error << endl;
+    return ok;
+}
+
+// Function to pick the trace file for a given generation (null outside the --trace-gens window)
+TraceFile* trace_for(const TbOptions& opts, TraceFile* tfp, long gen) {
+    if (gen < opts.trace_gen_start || (opts.trace_gen_stop >= 0 && gen > opts.trace_gen_stop)) return nullptr;
+    return tfp;
+}
+
+// One DUT with its own Verilator context, sim time and trace file. Each regression worker owns one, so any number of
+// models can run side by side on different threads.
+struct DutInstance {
+    VerilatedContext* context;
+    VGOL* dut;
+    vluint64_t sim_time = 0;             // sim time 
+    TraceFile* tfp = nullptr;
+
+    DutInstance(const TbOptions& opts, int argc, char** argv, const string& trace_file) {
+        context = new VerilatedContext;
+        context->commandArgs(argc, argv);
+        dut = new VGOL{context};
+#if VM_TRACE
+        if (opts.trace) {
+            tfp = new TraceFile;
+            context->traceEverOn(true);
+            dut->trace(tfp, opts.trace_depth);
+            tfp->open(trace_file.c_str());
+        }
+#endif
+
+        dut->Shift = 0;
+        dut->ShiftPar = 0;
+        dut->NextTimeTick = 0;
+        dut->DataIn = 0; // reset all inputs (DataInPar is only sampled while ShiftPar is high)
+        // Settle the model with the clock low, so that the first rising edge is seen as one, then wait a few clocks
+        // (no evals unless traced, see tick)
+        GOL_PROFILE_SCOPE(PHASE_TICK);
+        dut->clock = 0;
+        updateRTL(dut, sim_time, trace_for(opts, tfp, 0));
+        tick(dut, sim_time, trace_for(opts, tfp, 0), 5);
+    }
+
+    ~DutInstance() {
+#if VM_TRACE
+        if (tfp) {
+            tfp->close();
+            delete tfp;
+        }
+#endif
+        dut->final();
+        delete dut;
+        delete context;
+    }
+
+    DutInstance(const DutInstance&) = delete;
+    DutInstance& operator=(const DutInstance&) = delete;
+};
+
+// Function to name the trace file of regression worker w (waveform.vcd -> waveform_w3.vcd) when there are several
+string worker_trace_file(const TbOptions& opts, int w) {
+    string name = opts.trace_file;
+    if (opts.jobs == 1) return name;
+    size_t dot = name.rfind('.');
+    if (dot == string::npos) dot = name.size();
+    return name.substr(0, dot) + "_w" + to_string(w) + name.substr(dot);
+}
+
+// Function to name the stats file of test t (stats.csv -> stats_t3.csv), like the mismatch snapshots
+string test_stats_file(const TbOptions& opts, long t) {
+    string name = opts.stats_file;
+    size_t dot = name.rfind('.');
+    if (dot == string::npos || name.find('/', dot) != string::npos) dot = name.size();
+    return name.substr(0, dot) + "_t" + to_string(t + 1) + name.substr(dot);
+}
+
+// Result of running one stimulus on the DUT
+struct TestResult {
+    bool passed = true;
+    long generations = 0;                // generations simulated
+    long first_repeat = -1;              // first generation that repeats an earlier one (-1 = none found)
+    long period = 0;                     // period of that cycle
+    TileStats tiles;                     // active reference tiles per generation (--ref-engine=tiles)
+};
+
+// Function to run one test: load the stimulus into the DUT, then let it run for up to opts.generations generations
+// unless it converges early, checking each generation against the reference model (on a ReferenceChecker thread,
+// pipelined against the DUT). If game_states is not null, every captured DUT game state is appended to it (keyframe
+// + delta history for the GUI). If live is not null, each generation waits for the GUI to ask for it and is then
+// streamed to it (the test ends early if the GUI cancels).
+// Once the DUT state is seen to repeat with some period (see CycleDetector), the test stops, or with
+// --on-cycle=skip the DUT runs the remaining generations without readback and only the final state is checked.
+// The population, births, deaths and bounding box of every captured generation are worked out as it is captured
+// (see grid_stats) and streamed to the --stats file and to the GUI, so nothing has to go back over the history.
+TestResult run_test(DutInstance& inst, const PackedGrid& game_state, const TbOptions& opts, long t,
+                    GameHistory* game_states, LiveStream* live) {
+    VGOL* dut = inst.dut;
+    vluint64_t& sim_time = inst.sim_time;
+    TraceFile* tfp = inst.tfp;
+    TestResult result;
+    int rows = opts.rows;
+    int columns = opts.columns;
+
+    // Apply random grid to DUT 
+    if (opts.parallel_port) apply_stimulus_parallel(dut, game_state, sim_time, trace_for(opts, tfp, 0));
+    else apply_stimulus(dut, game_state, sim_time, trace_for(opts, tfp, 0));
+
+    // The reference model runs on a checker thread, one step behind the DUT. Generation 0 is the stimulus itself.
+    PackedGrid previous_DUT;
+    {
+        GOL_PROFILE_SCOPE(PHASE_CONVERT);
+        previous_DUT = game_state.clone();
+    }
+    PackedGrid packed_DUT(rows, columns);
+    // Only the first mismatch of a test is saved as snapshots (the flag is only used on the checker thread)
+    bool saved_snapshots = false;
+    ReferenceChecker checker(previous_DUT, [&](const Mismatch& mismatch) {
+        report_mismatch(mismatch, t, saved_snapshots ? nullptr : opts.snapshot_dir, opts.resume_generation);
+        saved_snapshots = true;
+    }, opts.tile_engine, opts.wrap, opts.rule);
+    long previous_gen = 0;
+
+    CycleDetector cycle;
+    if (opts.on_cycle != CYCLE_OFF) cycle.add(previous_DUT, 0);
+
+    StatsWriter stats_writer;
+    GenerationStats stats;
+    bool want_stats = opts.stats_file || game_states || live;
+    if (opts.stats_file) {
+        string error;
+        if (!stats_writer.open(test_stats_file(opts, t), rows, columns, error)) cerr << error << endl;
+        GOL_PROFILE_SCOPE(PHASE_STATS);
+        grid_stats(previous_DUT, nullptr, opts.resume_generation, stats);
+        stats_writer.write(stats);
+    }
+
+    // Function to capture the DUT game state of generation gen into packed_DUT. With the fast readback, the shift
+    // readback goes into shifted_DUT so the two can be compared; both buffers are reused for every generation.
+    PackedGrid shifted_DUT(rows, columns);
+    auto capture_dut = [&](long gen, TraceFile* gen_tfp) {
+        bool shift_out = !opts.fast_readback || (opts.shift_check > 0 && gen % opts.shift_check == 0);
+        if (opts.fast_readback) capture_game_state_fast(dut, packed_DUT);
+        if (shift_out) {
+            // capture game state of DUT
+            PackedGrid& target = opts.fast_readback ? shifted_DUT : packed_DUT;
+            if (opts.parallel_port) capture_game_state_parallel(dut, target, sim_time, gen_tfp);
+            else capture_game_state(dut, target, sim_time, gen_tfp);
+            if (opts.fast_readback && shifted_DUT != packed_DUT) {
+                cout << "ERROR: shifted out game state differs from GOL.status on Test#" << t+1
+                     << " Iteration #" << gen << endl;
+                result.passed = false;
+                swap(packed_DUT, shifted_DUT);
             }
         }
+        if (want_stats) {
+            // previous_DUT still holds the generation captured before this one
+            GOL_PROFILE_SCOPE(PHASE_STATS);
+            grid_stats(packed_DUT, &previous_DUT, opts.resume_generation + gen, stats);
+            stats_writer.write(stats);
+        }
+        if (game_states) {
+            GOL_PROFILE_SCOPE(PHASE_HISTORY);
+            game_states->push(packed_DUT, stats);
+        }
+    };
 
-        return live_neighbors;
+    // Function to hand the previous generation to the checker once the DUT state after it has been looked at
+    // (packed_DUT then becomes the previous generation and gets a recycled buffer for the next capture)
+    auto retire_previous = [&](long gen) {
+        if (previous_gen > 0) checker.submit(previous_gen, previous_DUT);
+        swap(previous_DUT, packed_DUT);
+        previous_gen = gen;
     };
 
-    // Iterate over each cell in the grid
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            int live_neighbors = count_live_neighbors(i, j);
-
-            // Apply the rules of the Game of Life
-            if (current_state[i][j]) {
-                // Rule 1: A live cell with 2 or 3 live neighbors stays alive
-                if (live_neighbors == 2 || live_neighbors == 3) {
-                    next_state[i][j] = true;
-                } else {
-                    next_state[i][j] = false;
-                }
-            } else {
-                // Rule 2: A dead cell with exactly 3 live neighbors becomes alive
-                if (live_neighbors == 3) {
-                    next_state[i][j] = true;
-                } else {
-                    next_state[i][j] = false;
+    // each cycle check game state and make sure it is correct. With --readback-every=K, the DUT runs K ticks
+    // between readbacks, and a model built with GENS=G computes G generations per tick, so the checker jumps the
+    // reference by K*G generations at a time.
+    const long gens_per_tick = opts.gens_per_tick;
+    for (long gen = 0; gen < opts.generations; ) {
+        // Each iteration produces generation next_gen
+        long next_gen = min<long>(gen + opts.readback_every * gens_per_tick, opts.generations);
+        if (live && !live->wait_for(gen + 1, next_gen)) break;
+        for (long k = gen + gens_per_tick; k <= next_gen; k += gens_per_tick) {
+            next_time_tick(dut, sim_time, trace_for(opts, tfp, k));
+        }
+        result.generations += next_gen - gen;
+        gen = next_gen;
+
+        // Capture output grid
+        capture_dut(gen, trace_for(opts, tfp, gen));
+        if (live && !live->push(gen, packed_DUT, stats)) {
+            retire_previous(gen);
+            break;
+        }
+        if (packed_DUT == previous_DUT) {
+            // Between single generations this is a still life. Further apart, the period divides the distance.
+            long period = gen - previous_gen;
+            if (!opts.headless && period == 1) cout << "Test#" << t+1 << " converged at iteration #" << gen << endl;
+            else if (!opts.headless) {
+                cout << "Test#" << t+1 << " repeats iteration #" << previous_gen << " at iteration #" << gen << endl;
+            }
+            result.first_repeat = gen;
+            result.period = period;
+            retire_previous(gen);
+            break;
+        } // convergence reached, terminate early
+
+        // Longer cycles (oscillators, guns bouncing around a closed grid, ...). Sampled every K*G generations, the
+        // period found is a multiple of K*G.
+        bool cycled = opts.on_cycle != CYCLE_OFF && cycle.add(packed_DUT, gen);
+        retire_previous(gen);
+        if (cycled) {
+            result.first_repeat = cycle.first_repeat;
+            result.period = cycle.period;
+            if (!opts.headless) {
+                cout << "Test#" << t+1 << " entered a period " << cycle.period << " cycle at iteration #"
+                     << cycle.first_repeat << " (confirmed at iteration #" << gen << ")" << endl;
+            }
+            if (opts.on_cycle == CYCLE_SKIP && gen < opts.generations) {
+                // Run the DUT through the remaining generations without reading it back. The reference only has
+                // to advance by the remaining generations modulo the period.
+                long remaining = opts.generations - gen;
+                for (long k = gens_per_tick; k <= remaining; k += gens_per_tick) {
+                    next_time_tick(dut, sim_time, trace_for(opts, tfp, gen + k));
                 }
+                result.generations += remaining;
+                capture_dut(opts.generations, trace_for(opts, tfp, opts.generations));
+                if (live) live->push(opts.generations, packed_DUT, stats);
+                checker.submit(previous_gen, previous_DUT);
+                checker.submit(opts.generations, packed_DUT, remaining % cycle.period);
+                previous_gen = 0;
             }
+            break;
         }
     }
 
-    return next_state;
+    // Check whatever is still in flight
+    if (previous_gen > 0) checker.submit(previous_gen, previous_DUT);
+    if (checker.finish()) result.passed = false;
+    string error;
+    if (!stats_writer.close(error)) cerr << error << endl;
+    result.tiles = checker.tile_stats();
+    if (opts.tile_engine && !opts.headless && result.tiles.generations) {
+        cout << "Test#" << t+1 << " reference tiles active per generation: " << result.tiles.mean() << " of "
+             << result.tiles.tiles << " on average (min " << result.tiles.active_min << ", max "
+             << result.tiles.active_max << ")" << endl;
+    }
+    return result;
 }
 
-int score_game_state(vector<vector<bool>> expected_state, vector<vector<bool>> dut_state) {
-    if (expected_state == dut_state) return 1;
+// Function to run the headless regression: opts.seeds random stimuli (or every pattern file given), no GUI. Test i
+// uses seed opts.seed + i, so a failing test can be reproduced with --seed=<its seed> --seeds=1. The tests are handed
+// out to opts.jobs worker threads through an atomic counter, each worker running its own DutInstance, and the
+// per-seed results are merged once all workers are done. Returns the number of failed tests.
+long run_regression(const TbOptions& opts, int argc, char** argv) {
+    long tests = opts.resume_file ? 1 : opts.patterns.empty() ? opts.seeds : long(opts.patterns.size());
+    vector<TestResult> results(tests);
+    atomic<long> next_seed(0);
+    auto start = chrono::steady_clock::now();
+
+    auto worker = [&](int w) {
+        DutInstance inst(opts, argc, argv, worker_trace_file(opts, w));
+        for (long i = next_seed.fetch_add(1, memory_order_relaxed); i < tests;
+             i = next_seed.fetch_add(1, memory_order_relaxed)) {
+            PackedGrid game_state;
+            if (make_stimulus(opts, i, game_state)) results[i] = run_test(inst, game_state, opts, i, nullptr, nullptr);
+            else results[i].passed = false;
+        }
+    };
+    int jobs = min<long>(opts.jobs, max(1L, tests));
+    if (jobs == 1) worker(0);
     else {
-        cout << "ERROR" << endl;
-        return 0;
+        vector<thread> workers;
+        for (int w = 0; w < jobs; ++w) workers.emplace_back(worker, w);
+        for (thread& th : workers) th.join();
     }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    // Merge the per-test results
+    long passed = 0, failed = 0, cycled = 0;
+    uint64_t generations = 0;
+    TileStats tiles;
+    for (long i = 0; i < tests; ++i) {
+        generations += results[i].generations;
+        tiles.merge(results[i].tiles);
+        if (results[i].period) cycled++;
+        if (results[i].passed) passed++;
+        else {
+            failed++;
+            if (opts.resume_file) cout << "FAILED resuming from " << opts.resume_file << endl;
+            else if (opts.patterns.empty()) cout << "FAILED seed " << opts.seed + i << endl;
+            else cout << "FAILED pattern " << opts.patterns[i] << endl;
+        }
+    }
+
+    double cells = double(generations) * opts.rows * opts.columns;
+    if (opts.resume_file) cout << "Regression: resumed from " << opts.resume_file;
+    else if (opts.patterns.empty()) cout << "Regression: " << tests << " seeds (base seed " << opts.seed << ")";
+    else cout << "Regression: " << tests << " patterns";
+    cout << " on " << jobs << " worker(s), " << opts.rows << "x" << opts.columns << (opts.wrap ? " torus" : " grid")
+         << (opts.rule.conway() ? "" : " under " + opts.rule.name()) << ", " << passed << " passed, " << failed
+         << " failed, " << cycled << " reached a cycle" << endl;
+    cout << "  " << generations << " generations in " << seconds << " s: " << generations / seconds
+         << " generations/s, " << cells / seconds << " cells/s" << endl;
+    cout << "  reference engine: " << packed_engine_name() << ", " << opts.rule.name()
+         << (life_rule_specialized(opts.rule) ? " (compiled kernel)" : " (shared runtime-mask kernel)") << endl;
+    if (opts.tile_engine && tiles.generations) {
+        cout << "  reference tiles active per generation: " << tiles.mean() << " of " << tiles.tiles << " ("
+             << 100.0 * tiles.mean() / tiles.tiles << "%), min " << tiles.active_min << ", max " << tiles.active_max
+             << endl;
+    }
+    return failed;
 }
 
-int main(int argc, char** argv) {
-    Verilated::commandArgs(argc, argv);
-    VGOL* dut = new VGOL;
-    // Parse arguments passed with `-G` flags
-    int rows = 30; // Default value
-    int columns = 30; // Default value
+// Function to benchmark raw model evaluation: load one random stimulus, then hold NextTimeTick high for
+// opts.bench_cycles clocks (GOL_GENS_PER_TICK generations per clock) and time only the evals.
+// Used by `make bench-mt` to compare Verilator --threads builds.
+void run_eval_benchmark(const TbOptions& opts, int argc, char** argv) {
+    DutInstance inst(opts, argc, argv, opts.trace_file);
+    VGOL* dut = inst.dut;
+    PackedGrid game_state = generate_stimulus(opts.rows, opts.columns, opts.seed, opts.density);
+    apply_stimulus(dut, game_state, inst.sim_time, inst.tfp);
+
+    auto start = chrono::steady_clock::now();
+    {
+        GOL_PROFILE_SCOPE(PHASE_TICK);
+        GOL_PROFILE_COUNT(generations, opts.bench_cycles * GOL_GENS_PER_TICK);
+        dut->NextTimeTick = 1;
+        tick(dut, inst.sim_time, inst.tfp, opts.bench_cycles);
+        dut->NextTimeTick = 0;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 
+    double evals = 2.0 * opts.bench_cycles;
+    cout << "Eval benchmark: " << inst.context->threads() << " thread(s), " << opts.rows << "x" << opts.columns
+         << " grid, " << evals << " evals in " << seconds << " s: " << evals / seconds << " evals/s, "
+         << double(opts.bench_cycles) * opts.gens_per_tick / seconds << " generations/s, "
+         << double(opts.bench_cycles) * opts.gens_per_tick * opts.rows * opts.columns / seconds << " cells/s" << endl;
+}
 
-    VerilatedVcdC* tfp = new VerilatedVcdC;
-    Verilated::traceEverOn(true);
-    dut->trace(tfp, 99);
-    tfp->open("waveform.vcd");
+int main(int argc, char** argv) {
+    // Verilator +args are handed to each DutInstance's context
+    TbOptions opts = parse_options(argc, argv);
+    auto start = chrono::steady_clock::now();
+
+    long failed = 0;
+    if (opts.bench_cycles > 0) {
+        run_eval_benchmark(opts, argc, argv);
+    } else if (opts.headless) {
+        failed = run_regression(opts, argc, argv);
+    } else {
+        DutInstance inst(opts, argc, argv, opts.trace_file);
+
+        // Run tests
+        int t = 0;
+        int run = 1;
+        while (run) {
+            t++;
+            // Generate random initial grid state (or load the next pattern file) if run=1, if run=2 do special
+            PackedGrid game_state;
+            if (run==1) {
+                long i = opts.patterns.empty() ? t - 1 : (t - 1) % long(opts.patterns.size());
+                if (opts.resume_file) {
+                    cout << "Test#" << t+1 << " resumed from " << opts.resume_file << " (generation "
+                         << opts.resume_generation << ")" << endl;
+                }
+                else if (opts.patterns.empty()) cout << "Test#" << t+1 << " seed " << opts.seed + i << endl;
+                else cout << "Test#" << t+1 << " pattern " << opts.patterns[i] << endl;
+                if (!make_stimulus(opts, i, game_state)) exit(EXIT_FAILURE);
+            }
+            else if (run==2) game_state = p46_gun(opts.rows, opts.columns);
+
+            if (opts.live) {
+                // The test runs on its own thread and streams each generation to the UI as it is produced. The
+                // UI returns when the user asks for a new game (or closes the window), which abandons the test.
+                LiveStream stream(opts.rows, opts.columns);
+                GenerationStats stats;
+                grid_stats(game_state, nullptr, opts.resume_generation, stats);
+                stream.push(0, game_state, stats);
+                TestResult result;
+                thread sim([&] {
+                    result = run_test(inst, game_state, opts, t, nullptr, &stream);
+                    stream.finish();
+                });
+                run = stream_game_states(stream, opts.wrap);
+                stream.cancel();
+                sim.join();
+                if (!result.passed) failed++;
+                continue;
+            }
 
-    dut->Shift = 0;
-    dut->NextTimeTick = 0;
-    dut->DataIn = 0; // reset all inputs
-    // Wait a few clocks
-    for (int i=0; i<5; ++i) {
-        dut->clock = 1;
-        updateRTL(dut, sim_time, tfp);
-        dut->clock = 0;
-        updateRTL(dut, sim_time, tfp);
-    }
+            // Buffer to store each iteration's game state
+            GameHistory game_states(opts.rows, opts.columns, opts.keyframe_interval);
+            if (!run_test(inst, game_state, opts, t, &game_states, nullptr).passed) failed++;
 
-    // Run tests
-    int t = 0;
-    int run = 1;
-    while (run) {
-        t++;
-        // Generate random initial grid state if run=1, if run=2 do special
-        vector<vector<bool>> game_state;
-        if (run==1) game_state = generate_stimulus(rows, columns);
-        else if (run==2) game_state = p46_gun(rows, columns);
-       
-
-        // Apply random grid to DUT 
-        apply_stimulus(dut, game_state, sim_time, tfp);
-
-        // Buffer to store each iteration's game state
-        vector<vector<vector<bool>>> game_states;
-
-        // Let each stimulus run for 200 cycles unless it converges early
-        // each cycle check game state and make sure it is correct
-        for (int c = 0; c < 200; ++c) {
-            // Toggle NextTimeTick for one clock cycle
-            dut->NextTimeTick = 1;
-            dut->clock = 1;
-            updateRTL(dut, sim_time, tfp);
-            dut->clock = 0;
-            updateRTL(dut, sim_time, tfp);
-
-            // Reset NextTimeTick and stall for one clock
-            dut->NextTimeTick = 0;
-            dut->clock = 1;
-            updateRTL(dut, sim_time, tfp);
-            dut->clock = 0;
-            updateRTL(dut, sim_time, tfp);
-
-            // Capture output grid
-            vector<vector<bool>> game_state_DUT(rows, vector<bool>(columns, 0));
-            capture_game_state(dut, game_state_DUT, sim_time, tfp); // capture game state of DUT
-            game_states.push_back(game_state_DUT);
-            if (game_state_DUT == game_state) {
-                cout << "Test#" << t+1 << " converged at iteration #" << c+1 << endl;
-                break;
-            } // convergence reached, terminate early
-
-            // convergence not reached, check if new game state is correct
-            game_state = calc_game_state(game_state); // update expected game state
-            if (!score_game_state(game_state_DUT, game_state)) {
-                // Error message if incorrect game state
-                cout << "On Test#" << t+1 << " Iteration #" << c+1 << endl;
-            }
+            // After the test case, cycle through the game states in the UI
+            run = cycle_game_states(game_states, opts.wrap);
         }
-        // After the test case, cycle through the game states in the UI
-        run = cycle_game_states(game_states);
     }
 
-    tfp->close();
-    delete dut;
-    exit(EXIT_SUCCESS);
-}
-
+    // Phase breakdown of the whole run (PROFILE=1 builds)
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (GOL_PROFILE) profile_report(cout, opts.rows, opts.columns, seconds);
+    string error;
+    if (opts.profile_json && !profile_write_json(opts.profile_json, opts.rows, opts.columns, seconds, error)) {
+        cerr << error << endl;
+    }
 
+    exit(failed ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,143 @@
+#include <vector>
+#include <algorithm>
+#include "GOL_tiles.h"
+
+using namespace std;
+
+void TileStats::add(int count) {
+    active_min = generations ? min(active_min, count) : count;
+    active_max = max(active_max, count);
+    active_sum += count;
+    generations++;
+}
+
+void TileStats::merge(const TileStats& other) {
+    if (!other.generations) return;
+    active_min = generations ? min(active_min, other.active_min) : other.active_min;
+    active_max = max(active_max, other.active_max);
+    active_sum += other.active_sum;
+    generations += other.generations;
+    tiles = max(tiles, other.tiles);
+}
+
+TileEngine::TileEngine(const PackedGrid& initial_state, bool wrap, const LifeRule& rule)
+    : current(initial_state.clone()), previous(initial_state.clone()), tiles_x(initial_state.words_per_row),
+      tiles_y((initial_state.rows + TILE_ROWS - 1) / TILE_ROWS), wrap(wrap), rule(rule) {
+    flags.assign(tile_count(), ALL);
+    next_flags.assign(tile_count(), 0);
+    band.assign(3 * tiles_x, 0);
+}
+
+// Function to mark every tile as changed, so the next step recomputes the whole grid
+void TileEngine::invalidate() {
+    fill(flags.begin(), flags.end(), ALL);
+}
+
+// Off the grid there is nothing to change, except on a torus, where the tile on the opposite edge takes its place
+uint16_t TileEngine::flags_at(int ty, int tx) const {
+    if (wrap) {
+        ty = (ty + tiles_y) % tiles_y;
+        tx = (tx + tiles_x) % tiles_x;
+    }
+    if (ty < 0 || ty >= tiles_y || tx < 0 || tx >= tiles_x) return 0;
+    return flags[ty * tiles_x + tx];
+}
+
+// A tile depends on its own cells and the ring of cells around it, which belong to the eight neighboring tiles
+bool TileEngine::needs_update(int ty, int tx) const {
+    return (flags_at(ty, tx) & CHANGED) ||
+           (flags_at(ty - 1, tx) & BOTTOM) || (flags_at(ty + 1, tx) & TOP) ||
+           (flags_at(ty, tx - 1) & RIGHT) || (flags_at(ty, tx + 1) & LEFT) ||
+           (flags_at(ty - 1, tx - 1) & BOTTOM_RIGHT) || (flags_at(ty - 1, tx + 1) & BOTTOM_LEFT) ||
+           (flags_at(ty + 1, tx - 1) & TOP_RIGHT) || (flags_at(ty + 1, tx + 1) & TOP_LEFT);
+}
+
+// Function to fold the difference between a tile row's old and new word into the tile's change flags. right_bit is
+// the tile's last column (63, except in a partial last word of the row).
+uint16_t TileEngine::row_flags(uint64_t diff, bool first, bool last, int right_bit) {
+    if (!diff) return 0;
+    bool left = diff & 1, right = (diff >> right_bit) & 1;
+    uint16_t changed = CHANGED | (left ? LEFT : 0) | (right ? RIGHT : 0);
+    if (first) changed |= TOP | (left ? TOP_LEFT : 0) | (right ? TOP_RIGHT : 0);
+    if (last) changed |= BOTTOM | (left ? BOTTOM_LEFT : 0) | (right ? BOTTOM_RIGHT : 0);
+    return changed;
+}
+
+int TileEngine::right_bit(int tx) const {
+    return (tx == tiles_x - 1 && (current.cols & 63)) ? (current.cols & 63) - 1 : 63;
+}
+
+// Function to compute the next generation of one tile into `previous` and report what changed in it
+uint16_t TileEngine::update_tile(int ty, int tx) {
+    int first = ty * TILE_ROWS, last = min(current.rows, first + TILE_ROWS) - 1;
+    int w = tx;
+    uint64_t tail = (w == current.words_per_row - 1 && (current.cols & 63)) ? (uint64_t(1) << (current.cols & 63)) - 1
+                                                                          : ~uint64_t(0);
+    int rb = right_bit(tx);
+    // On a torus the cells on the grid's edges see the opposite edge, so edge tiles are fixed up before the diff
+    bool fix_edges = wrap && (ty == 0 || ty == tiles_y - 1 || tx == 0 || tx == tiles_x - 1);
+    uint16_t changed = 0;
+    for (int i = first; i <= last; ++i) {
+        const uint64_t* up = current.row(i - 1);
+        const uint64_t* mid = current.row(i);
+        const uint64_t* dn = current.row(i + 1);
+        uint64_t ul = (up[w] << 1) | (up[w - 1] >> 63), ur = (up[w] >> 1) | (up[w + 1] << 63);
+        uint64_t l = (mid[w] << 1) | (mid[w - 1] >> 63), r = (mid[w] >> 1) | (mid[w + 1] << 63);
+        uint64_t dl = (dn[w] << 1) | (dn[w - 1] >> 63), dr = (dn[w] >> 1) | (dn[w + 1] << 63);
+        uint64_t next = life_rule_word(rule, ul, up[w], ur, l, mid[w], r, dl, dn[w], dr) & tail;
+        previous.row(i)[w] = next;
+        if (!fix_edges) changed |= row_flags(next ^ mid[w], i == first, i == last, rb);
+    }
+    if (fix_edges) {
+        wrap_packed_edges(current, previous, first, last, 64 * w, min(current.cols, 64 * w + 64) - 1, rule);
+        for (int i = first; i <= last; ++i) {
+            changed |= row_flags(previous.row(i)[w] ^ current.row(i)[w], i == first, i == last, rb);
+        }
+    }
+    return changed;
+}
+
+// One generation. The tiles that need an update are counted first: if more than a quarter of the grid does, the
+// single-word tile kernel would lose to the vectorized whole-grid engine, so the whole grid is stepped instead and
+// the flags come from diffing the two buffers.
+int TileEngine::step() {
+    active = 0;
+    for (int ty = 0; ty < tiles_y; ++ty) {
+        for (int tx = 0; tx < tiles_x; ++tx) {
+            bool update = needs_update(ty, tx);
+            next_flags[ty * tiles_x + tx] = update;  // remembered until the flags are computed below
+            active += update;
+        }
+    }
+
+    if (active * 4 > tile_count()) {
+        calc_packed_state(current, previous, wrap, rule);
+        uint64_t* any = band.data();
+        uint64_t* top = any + tiles_x;
+        uint64_t* bottom = top + tiles_x;
+        for (int ty = 0; ty < tiles_y; ++ty) {
+            // OR the differences of each band of tile rows together, keeping the first and last row apart
+            int first = ty * TILE_ROWS, last = min(current.rows, first + TILE_ROWS) - 1;
+            fill(any, any + tiles_x, 0);
+            for (int i = first; i <= last; ++i) {
+                const uint64_t* old_row = current.row(i);
+                const uint64_t* new_row = previous.row(i);
+                for (int w = 0; w < tiles_x; ++w) any[w] |= old_row[w] ^ new_row[w];
+            }
+            for (int w = 0; w < tiles_x; ++w) {
+                top[w] = current.row(first)[w] ^ previous.row(first)[w];
+                bottom[w] = current.row(last)[w] ^ previous.row(last)[w];
+                int rb = right_bit(w);
+                next_flags[ty * tiles_x + w] = row_flags(any[w], false, false, rb) | row_flags(top[w], true, false, rb) |
+                                               row_flags(bottom[w], false, true, rb);
+            }
+        }
+    } else {
+        for (int t = 0; t < tile_count(); ++t) {
+            if (next_flags[t]) next_flags[t] = update_tile(t / tiles_x, t % tiles_x);
+        }
+    }
+    swap(current, previous);
+    swap(flags, next_flags);
+    return active;
+}
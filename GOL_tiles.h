@@ -0,0 +1,69 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include "GOL_ref.h"
+
+using namespace std;
+
+// Per-run summary of how many tiles the tile engine actually recomputed
+struct TileStats {
+    int tiles = 0;                   // tiles in the grid
+    long generations = 0;            // single generation steps taken
+    long active_sum = 0;             // recomputed tiles summed over all steps
+    int active_min = 0;
+    int active_max = 0;
+
+    void add(int active);
+    void merge(const TileStats& other);
+    double mean() const { return generations ? double(active_sum) / generations : 0; }
+};
+
+// Reference engine that skips the parts of the grid that have settled. The packed grid is cut into tiles of one
+// word (64 columns) by 64 rows. After each generation every tile records whether it changed at all and whether its
+// edge rows/columns and corner cells changed; a tile is only recomputed if it changed itself or one of its eight
+// neighbors changed next to it. Everything else is provably the same as one generation ago, which is what the second
+// buffer already holds, so skipped tiles cost nothing (not even a copy). With wrap (a torus), the tiles on opposite
+// edges of the grid are neighbors. This holds for any rule, as a cell's next state only depends on its 3x3 window.
+// Tiles are stepped with the rule tested per word; once many tiles are active the grid goes through the rule's
+// compiled kernel in calc_packed_state.
+class TileEngine {
+public:
+    enum { TILE_ROWS = 64 };
+
+    explicit TileEngine(const PackedGrid& initial_state, bool wrap = false, const LifeRule& rule = LifeRule());
+
+    // Advance one generation; returns the number of tiles that needed recomputing (active tiles)
+    int step();
+    const PackedGrid& state() const { return current; }
+
+    // The state one generation before state() (right after step() only)
+    const PackedGrid& previous_state() const { return previous; }
+
+    // Direct access for changes made outside the engine (e.g. a long jump); call invalidate() afterwards
+    PackedGrid& mutable_state() { return current; }
+    void invalidate();
+
+    int tile_count() const { return tiles_x * tiles_y; }
+
+private:
+    enum : uint16_t {
+        CHANGED = 1 << 0, TOP = 1 << 1, BOTTOM = 1 << 2, LEFT = 1 << 3, RIGHT = 1 << 4,
+        TOP_LEFT = 1 << 5, TOP_RIGHT = 1 << 6, BOTTOM_LEFT = 1 << 7, BOTTOM_RIGHT = 1 << 8,
+        ALL = 0x1FF,
+    };
+    static uint16_t row_flags(uint64_t diff, bool first, bool last, int right_bit);
+    int right_bit(int tx) const;
+    uint16_t flags_at(int ty, int tx) const;
+    bool needs_update(int ty, int tx) const;
+    uint16_t update_tile(int ty, int tx);
+
+    PackedGrid current;
+    PackedGrid previous;             // one generation older, equal to current on every tile that didn't change
+    int tiles_x, tiles_y;
+    bool wrap;
+    LifeRule rule;
+    vector<uint16_t> flags;          // what changed in each tile in the last generation
+    vector<uint16_t> next_flags;
+    vector<uint64_t> band;           // scratch for whole-grid steps: per-column differences of one band of tiles
+    int active = 0;
+};